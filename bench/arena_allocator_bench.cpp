@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/allocator/arena_allocator.h>
+#include <cpp_utils/allocator/pool_allocator.h>
+#include <cpp_utils/container/avl_map.h>
+
+#include <cstdint>
+#include <functional>
+
+// builds a map of state.range(0) entries and drops it, like a request scoped index
+template<typename Map, typename MakeMap>
+static void build_and_drop(benchmark::State &state, MakeMap &&make_map) {
+    auto n = static_cast<uint64_t>(state.range(0));
+    for (auto _: state) {
+        Map map = make_map();
+        for (uint64_t i = 0; i < n; ++i) {
+            // a permutation of 0..n-1 for odd multipliers and power of two n
+            map.emplace((i * 0x9E3779B1U) & (n - 1), i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AvlMapStdAllocator(benchmark::State &state) {
+    using Map = alp_utils::avl_map<uint64_t, uint64_t>;
+    build_and_drop<Map>(state, [] { return Map(); });
+}
+
+BENCHMARK(BM_AvlMapStdAllocator)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+
+static void BM_AvlMapPoolAllocator(benchmark::State &state) {
+    using Map = alp_utils::avl_map<uint64_t, uint64_t, std::less<uint64_t>,
+            alp_utils::pool_allocator<std::pair<const uint64_t, uint64_t>>>;
+    build_and_drop<Map>(state, [] { return Map(); });
+}
+
+BENCHMARK(BM_AvlMapPoolAllocator)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+
+// the arena lives as long as one map, dropping both frees the blocks and not the nodes
+static void BM_AvlMapArenaAllocator(benchmark::State &state) {
+    using Alloc = alp_utils::arena_allocator<std::pair<const uint64_t, uint64_t>>;
+    using Map = alp_utils::avl_map<uint64_t, uint64_t, std::less<uint64_t>, Alloc>;
+    auto n = static_cast<uint64_t>(state.range(0));
+    for (auto _: state) {
+        alp_utils::Arena arena;
+        Map map{Alloc(arena)};
+        for (uint64_t i = 0; i < n; ++i) {
+            map.emplace((i * 0x9E3779B1U) & (n - 1), i);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AvlMapArenaAllocator)->RangeMultiplier(8)->Range(1 << 8, 1 << 20);
+
+BENCHMARK_MAIN();
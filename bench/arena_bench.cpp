@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/allocator/arena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <sys/resource.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using alp_utils::Arena;
+using alp_utils::arena_options;
+
+// dTLB load misses of this thread, the counter is skipped where perf events are not available
+class dtlb_counter {
+public:
+    dtlb_counter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~dtlb_counter() {
+#if defined(__linux__)
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    int64_t read() const {
+        int64_t value = 0;
+#if defined(__linux__)
+        if (fd_ >= 0 && ::read(fd_, &value, sizeof(value)) != sizeof(value)) {
+            value = 0;
+        }
+#endif
+        return value;
+    }
+
+private:
+    int fd_{-1};
+};
+
+static int64_t minor_faults() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+// 64 byte nodes in a random cycle, so the walk touches the blocks in no particular order
+struct node {
+    node *next;
+    uint64_t payload[7];
+};
+
+static constexpr size_t kBytes = 512 << 20;
+static constexpr size_t kNodes = kBytes / sizeof(node);
+
+static void build_and_walk(benchmark::State &state, const arena_options &options) {
+    std::vector<uint32_t> order(kNodes);
+    for (uint32_t i = 0; i < kNodes; ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    std::vector<node *> nodes(kNodes);
+
+    dtlb_counter dtlb;
+    int64_t faults = 0;
+    int64_t misses = 0;
+    for (auto _: state) {
+        auto faults_before = minor_faults();
+        Arena arena(options);
+        for (auto &n: nodes) {
+            n = reinterpret_cast<node *>(arena.allocate_aligned(sizeof(node)));
+        }
+        for (size_t i = 0; i < kNodes; ++i) {
+            nodes[order[i]]->next = nodes[order[(i + 1) % kNodes]];
+        }
+        faults += minor_faults() - faults_before;
+
+        auto misses_before = dtlb.read();
+        auto n = nodes[0];
+        for (size_t i = 0; i < kNodes; ++i) {
+            n = n->next;
+        }
+        benchmark::DoNotOptimize(n);
+        misses += dtlb.read() - misses_before;
+    }
+    state.counters["page_faults"] = benchmark::Counter(static_cast<double>(faults), benchmark::Counter::kAvgIterations);
+    if (dtlb.available()) {
+        state.counters["dtlb_misses"] = benchmark::Counter(static_cast<double>(misses),
+                                                           benchmark::Counter::kAvgIterations);
+    }
+    state.SetItemsProcessed(state.iterations() * kNodes);
+}
+
+static void BM_ArenaDefaultBlocks(benchmark::State &state) {
+    build_and_walk(state, arena_options{});
+}
+
+BENCHMARK(BM_ArenaDefaultBlocks)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+static void BM_ArenaGrowingBlocks(benchmark::State &state) {
+    build_and_walk(state, arena_options{.block_size = 64 << 10, .max_block_size = 64 << 20, .growth_factor = 2});
+}
+
+BENCHMARK(BM_ArenaGrowingBlocks)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+static void BM_ArenaHugePages(benchmark::State &state) {
+    build_and_walk(state, arena_options{.block_size = 2 << 20, .max_block_size = 64 << 20, .growth_factor = 2,
+            .huge_pages = true});
+}
+
+BENCHMARK(BM_ArenaHugePages)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+BENCHMARK_MAIN();
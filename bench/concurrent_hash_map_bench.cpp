@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/container/concurrent_hash_map.h>
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <unordered_map>
+
+// 90% lookups, 5% inserts and 5% erases on a map of about kKeys / 2 entries
+static constexpr uint64_t kKeys = 1 << 16;
+
+template<typename Map>
+static void prefill(Map &map) {
+    for (uint64_t key = 0; key < kKeys; key += 2) {
+        map.emplace(key, key);
+    }
+}
+
+template<typename Find, typename Insert, typename Erase>
+static void mixed(benchmark::State &state, Find &&find, Insert &&insert, Erase &&erase) {
+    std::mt19937_64 gen(state.thread_index());
+    int64_t hits = 0;
+    for (auto _: state) {
+        auto r = gen();
+        auto key = r % kKeys;
+        auto op = (r >> 32) % 100;
+        if (op < 90) {
+            hits += find(key);
+        } else if (op < 95) {
+            insert(key);
+        } else {
+            erase(key);
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ConcurrentHashMap(benchmark::State &state) {
+    using Map = alp_utils::concurrent_hash_map<uint64_t, uint64_t>;
+    static Map &map = *[] {
+        auto map = new Map;
+        prefill(*map);
+        return map;
+    }();
+    mixed(state, [](uint64_t key) { return map.get(key).value_or(0); },
+          [](uint64_t key) { map.emplace(key, key); },
+          [](uint64_t key) { map.erase(key); });
+}
+
+BENCHMARK(BM_ConcurrentHashMap)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_SharedMutexUnorderedMap(benchmark::State &state) {
+    using Map = std::unordered_map<uint64_t, uint64_t>;
+    static std::shared_mutex mutex;
+    static Map &map = *[] {
+        auto map = new Map;
+        prefill(*map);
+        return map;
+    }();
+    mixed(state, [](uint64_t key) -> uint64_t {
+              std::shared_lock<std::shared_mutex> lock(mutex);
+              auto it = map.find(key);
+              return it != map.end() ? it->second : 0;
+          },
+          [](uint64_t key) {
+              std::lock_guard<std::shared_mutex> lock(mutex);
+              map.emplace(key, key);
+          },
+          [](uint64_t key) {
+              std::lock_guard<std::shared_mutex> lock(mutex);
+              map.erase(key);
+          });
+}
+
+BENCHMARK(BM_SharedMutexUnorderedMap)->ThreadRange(1, 64)->UseRealTime();
+
+// inserts into a fresh map, every run goes through all the resizes from 16 buckets
+static void BM_ConcurrentHashMapGrow(benchmark::State &state) {
+    for (auto _: state) {
+        alp_utils::concurrent_hash_map<uint64_t, uint64_t> map;
+        prefill(map);
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kKeys / 2);
+}
+
+BENCHMARK(BM_ConcurrentHashMapGrow);
+
+static void BM_UnorderedMapGrow(benchmark::State &state) {
+    for (auto _: state) {
+        std::unordered_map<uint64_t, uint64_t> map;
+        prefill(map);
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kKeys / 2);
+}
+
+BENCHMARK(BM_UnorderedMapGrow);
+
+BENCHMARK_MAIN();
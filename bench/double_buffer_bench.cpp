@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/double_buffer.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+// lookups in a large map while thread 0 keeps updating single entries, and batched updates
+static constexpr int64_t kEntries = 100000;
+
+using Map = std::unordered_map<int64_t, int64_t>;
+
+static Map make_map() {
+    Map map;
+    for (int64_t i = 0; i < kEntries; ++i) {
+        map.emplace(i, i);
+    }
+    return map;
+}
+
+static alp_utils::double_buffer<Map> map_buffer(make_map());
+
+static void BM_DoubleBufferRead(benchmark::State &state) {
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        int64_t key = 0;
+        for (auto _: state) {
+            map_buffer.update([key](Map &map) { ++map[key]; });
+            key = (key + 1) % kEntries;
+        }
+        state.SetItemsProcessed(state.iterations());
+        return;
+    }
+    int64_t key = state.thread_index();
+    int64_t sum = 0;
+    for (auto _: state) {
+        auto map = map_buffer.read();
+        sum += map->find(key)->second;
+        key = (key + 7) % kEntries;
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_DoubleBufferRead)->ThreadRange(1, 8)->UseRealTime();
+
+// update throughput of one writer when updates are queued and flushed in batches of range(0)
+static void BM_DoubleBufferBatch(benchmark::State &state) {
+    alp_utils::double_buffer<Map> buffer(make_map());
+    auto batch = state.range(0);
+    int64_t key = 0;
+    for (auto _: state) {
+        for (int64_t i = 0; i < batch; ++i) {
+            buffer.enqueue([key](Map &map) { ++map[key]; });
+            key = (key + 1) % kEntries;
+        }
+        buffer.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(BM_DoubleBufferBatch)->RangeMultiplier(4)->Range(1, 1024);
+
+BENCHMARK_MAIN();
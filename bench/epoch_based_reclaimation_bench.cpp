@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/epoch_based_reclaimation.h>
+#include <cpp_utils/concurrency/hazard_ptr.h>
+
+#include <atomic>
+
+// read throughput of a traversal of a shared list, thread 0 keeps replacing the head and retiring it
+static constexpr int kListSize = 32;
+
+struct Node {
+    explicit Node(int v, Node *n = nullptr) : val(v), next(n) {}
+
+    int val;
+    std::atomic<Node *> next;
+};
+
+struct List {
+    List() {
+        for (int i = 0; i < kListSize; ++i) {
+            head.store(new Node(i, head.load()));
+        }
+    }
+
+    ~List() {
+        auto node = head.load();
+        while (node != nullptr) {
+            auto next = node->next.load();
+            delete node;
+            node = next;
+        }
+    }
+
+    std::atomic<Node *> head{nullptr};
+};
+
+static List list;
+
+template<typename Retire>
+static void replace_head(Retire &&retire) {
+    auto old = list.head.load();
+    list.head.store(new Node(old->val, old->next.load()));
+    retire(old);
+}
+
+static void BM_HazpRead(benchmark::State &state) {
+    using namespace alp_utils::hazp;
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        for (auto _: state) {
+            replace_head([](Node *node) { retire(node); });
+        }
+        return;
+    }
+    // hand over hand, one hazard pointer per step
+    auto hptrs = make_hazard_ptr<2>();
+    int64_t sum = 0;
+    for (auto _: state) {
+        auto node = hptrs[0].protect(list.head);
+        while (node != nullptr) {
+            sum += node->val;
+            auto next = hptrs[1].protect(node->next);
+            std::swap(hptrs[0], hptrs[1]);
+            node = next;
+        }
+        hptrs[0].reset();
+        hptrs[1].reset();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * kListSize);
+}
+
+BENCHMARK(BM_HazpRead)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_EbrRead(benchmark::State &state) {
+    using namespace alp_utils::ebr;
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        for (auto _: state) {
+            replace_head([](Node *node) { retire(node); });
+        }
+        return;
+    }
+    // one critical section per traversal, plain loads inside it
+    int64_t sum = 0;
+    for (auto _: state) {
+        guard g;
+        auto node = g.protect(list.head);
+        while (node != nullptr) {
+            sum += node->val;
+            node = g.protect(node->next);
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * kListSize);
+}
+
+BENCHMARK(BM_EbrRead)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/hazard_ptr.h>
+
+#include <atomic>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+using namespace alp_utils::hazp;
+
+// one bulk reclaim pass, kReclaimThreshold retired nodes matched against N live hazard pointers
+static constexpr int kRetired = 1000;
+
+struct ScanData {
+    std::vector<uintptr_t> protected_ptrs;
+    std::vector<const void *> retired;
+
+    explicit ScanData(size_t live) {
+        std::mt19937_64 gen(42);
+        std::vector<uintptr_t> objs(kRetired);
+        for (auto &obj: objs) {
+            obj = (gen() & ~uintptr_t{0xf}) | 0x10;
+        }
+        // half of the protected pointers hit a retired node
+        for (size_t i = 0; i < live; ++i) {
+            protected_ptrs.push_back(i % 2 == 0 ? objs[gen() % kRetired] : (gen() & ~uintptr_t{0xf}) | 0x10);
+        }
+        for (auto obj: objs) {
+            retired.push_back(reinterpret_cast<const void *>(obj));
+        }
+    }
+};
+
+static void BM_ScanUnorderedSet(benchmark::State &state) {
+    ScanData data(state.range(0));
+    for (auto _: state) {
+        std::unordered_set<const void *> protected_ptrs;
+        protected_ptrs.reserve(data.protected_ptrs.size());
+        for (auto ptr: data.protected_ptrs) {
+            protected_ptrs.insert(reinterpret_cast<const void *>(ptr));
+        }
+        int kept = 0;
+        for (auto obj: data.retired) {
+            kept += protected_ptrs.contains(obj);
+        }
+        benchmark::DoNotOptimize(kept);
+    }
+    state.SetItemsProcessed(state.iterations() * kRetired);
+}
+
+BENCHMARK(BM_ScanUnorderedSet)->Arg(8)->Arg(64)->Arg(512);
+
+static void BM_ScanSortedArray(benchmark::State &state) {
+    ScanData data(state.range(0));
+    detail::hazptr_set protected_ptrs;
+    for (auto _: state) {
+        protected_ptrs.clear();
+        protected_ptrs.reserve(data.protected_ptrs.size());
+        for (auto ptr: data.protected_ptrs) {
+            protected_ptrs.insert(ptr);
+        }
+        protected_ptrs.seal();
+        int kept = 0;
+        for (auto obj: data.retired) {
+            kept += protected_ptrs.contains(obj);
+        }
+        benchmark::DoNotOptimize(kept);
+    }
+    state.SetItemsProcessed(state.iterations() * kRetired);
+}
+
+BENCHMARK(BM_ScanSortedArray)->Arg(8)->Arg(64)->Arg(512);
+
+// end to end: retire a full batch while N hazard pointers are live, then reclaim
+static void BM_RetireReclaim(benchmark::State &state) {
+    const auto live = static_cast<size_t>(state.range(0));
+    std::vector<std::atomic<int *>> objs(live);
+    std::vector<hazard_ptr> hptrs;
+    for (size_t i = 0; i < live; ++i) {
+        objs[i].store(new int(static_cast<int>(i)));
+        hptrs.emplace_back(make_hazard_ptr());
+        hptrs.back().protect(objs[i]);
+    }
+
+    for (auto _: state) {
+        for (int i = 0; i < kRetired; ++i) {
+            retire(new int(i));
+        }
+        reclaim();
+    }
+    state.SetItemsProcessed(state.iterations() * kRetired);
+
+    for (auto &h: hptrs) {
+        h.reset();
+    }
+    for (auto &obj: objs) {
+        delete obj.load();
+    }
+}
+
+BENCHMARK(BM_RetireReclaim)->Arg(8)->Arg(64)->Arg(512);
+
+// retire throughput with private batches, 1 is the unbatched path
+static void BM_Retire(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        reclaimer::instance().set_retire_batch_size(static_cast<uint32_t>(state.range(0)));
+    }
+    for (auto _: state) {
+        retire(new int(0));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        reclaimer::instance().set_retire_batch_size(1);
+    }
+}
+
+BENCHMARK(BM_Retire)->Arg(1)->Arg(64)->Threads(1)->Threads(4)->UseRealTime();
+
+struct Plain {
+    int val{0};
+};
+
+struct Intrusive : hazptr_obj_base<Intrusive> {
+    int val{0};
+};
+
+// retire path allocations, a retire_node per object against the link embedded in the object
+static void BM_RetireNode(benchmark::State &state) {
+    for (auto _: state) {
+        retire(new Plain);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RetireNode);
+
+static void BM_RetireIntrusive(benchmark::State &state) {
+    for (auto _: state) {
+        (new Intrusive)->retire();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RetireIntrusive);
+
+BENCHMARK_MAIN();
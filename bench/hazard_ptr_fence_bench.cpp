@@ -0,0 +1,78 @@
+#ifndef ALP_HAZP_ASYMMETRIC_FENCE
+#define ALP_HAZP_ASYMMETRIC_FENCE
+#endif
+
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/hazard_ptr.h>
+
+#include <atomic>
+
+using namespace alp_utils::hazp;
+
+// reader throughput of protect, asymmetric fence against the seq_cst fence protect used before
+static std::atomic<int *> shared_obj{new int(42)};
+
+template<typename T>
+static T *protect_symmetric(hazard_ptr &h, std::atomic<T *> &ptr) {
+    while (true) {
+        auto plain_ptr = h.try_protect(ptr);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (plain_ptr == ptr.load(std::memory_order_acquire)) [[likely]] {
+            return plain_ptr;
+        }
+    }
+}
+
+static void BM_ProtectSeqCstFence(benchmark::State &state) {
+    auto h = make_hazard_ptr();
+    int sum = 0;
+    for (auto _: state) {
+        sum += *protect_symmetric(h, shared_obj);
+        h.reset();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ProtectSeqCstFence)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ProtectAsymmetricFence(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        state.counters["membarrier"] = detail::membarrier_available();
+    }
+    auto h = make_hazard_ptr();
+    int sum = 0;
+    for (auto _: state) {
+        sum += *h.protect(shared_obj);
+        h.reset();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ProtectAsymmetricFence)->ThreadRange(1, 8)->UseRealTime();
+
+// readers keep running while one thread retires and reclaims, the heavy fence is paid here
+static void BM_ProtectWithReclaimer(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        for (auto _: state) {
+            for (int i = 0; i < 100; ++i) {
+                retire(new int(i));
+            }
+            reclaim();
+        }
+        return;
+    }
+    auto h = make_hazard_ptr();
+    int sum = 0;
+    for (auto _: state) {
+        sum += *h.protect(shared_obj);
+        h.reset();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ProtectWithReclaimer)->Threads(2)->Threads(4)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/epoch_based_reclaimation.h>
+#include <cpp_utils/concurrency/interval_based_reclaimation.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// read cost of ibr against ebr on a list traversal, and the memory a stalled reader pins
+static constexpr int kListSize = 32;
+
+struct EbrNode {
+    explicit EbrNode(int v, EbrNode *n = nullptr) : val(v), next(n) {}
+
+    int val;
+    std::atomic<EbrNode *> next;
+};
+
+struct IbrNode : alp_utils::ibr::ibr_obj_base<IbrNode> {
+    explicit IbrNode(int v, IbrNode *n = nullptr) : val(v), next(n) {}
+
+    int val;
+    std::atomic<IbrNode *> next;
+};
+
+template<typename N>
+struct List {
+    List() {
+        for (int i = 0; i < kListSize; ++i) {
+            head.store(new N(i, head.load()));
+        }
+    }
+
+    std::atomic<N *> head{nullptr};
+};
+
+static List<EbrNode> ebr_list;
+static List<IbrNode> ibr_list;
+
+template<typename Guard, typename N>
+static int64_t traverse(Guard &g, List<N> &list) {
+    int64_t sum = 0;
+    auto node = g.protect(list.head);
+    while (node != nullptr) {
+        sum += node->val;
+        node = g.protect(node->next);
+    }
+    return sum;
+}
+
+static void BM_EbrRead(benchmark::State &state) {
+    using namespace alp_utils::ebr;
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        for (auto _: state) {
+            auto old = ebr_list.head.load();
+            ebr_list.head.store(new EbrNode(old->val, old->next.load()));
+            retire(old);
+        }
+        return;
+    }
+    int64_t sum = 0;
+    for (auto _: state) {
+        guard g;
+        sum += traverse(g, ebr_list);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * kListSize);
+}
+
+BENCHMARK(BM_EbrRead)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_IbrRead(benchmark::State &state) {
+    using namespace alp_utils::ibr;
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        for (auto _: state) {
+            auto old = ibr_list.head.load();
+            ibr_list.head.store(new IbrNode(old->val, old->next.load()));
+            old->retire();
+        }
+        return;
+    }
+    int64_t sum = 0;
+    for (auto _: state) {
+        guard g;
+        sum += traverse(g, ibr_list);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * kListSize);
+}
+
+BENCHMARK(BM_IbrRead)->ThreadRange(1, 8)->UseRealTime();
+
+// one reader sits in a critical section for the whole run, objects still in limbo at the end
+// show how much memory it pins: everything under ebr, only what it could have seen under ibr
+template<typename Enter, typename Retire, typename Pending>
+static void stalled_reader(benchmark::State &state, Enter &&enter, Retire &&retire, Pending &&pending) {
+    std::atomic<bool> entered{false};
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        auto g = enter();
+        entered.store(true);
+        while (!done.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    for (auto _: state) {
+        retire();
+    }
+    state.counters["pinned"] = static_cast<double>(pending());
+    done.store(true);
+    reader.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_EbrStalledReader(benchmark::State &state) {
+    using namespace alp_utils::ebr;
+    stalled_reader(state, [] { return std::make_unique<guard>(); },
+                   [] { retire(new EbrNode(0)); },
+                   [] { return reclaimer::instance().pending(); });
+    reclaim();
+}
+
+BENCHMARK(BM_EbrStalledReader)->Iterations(100000);
+
+static void BM_IbrStalledReader(benchmark::State &state) {
+    using namespace alp_utils::ibr;
+    stalled_reader(state, [] { return std::make_unique<guard>(); },
+                   [] { (new IbrNode(0))->retire(); },
+                   [] { return reclaimer::instance().pending(); });
+    reclaim();
+}
+
+BENCHMARK(BM_IbrStalledReader)->Iterations(100000);
+
+BENCHMARK_MAIN();
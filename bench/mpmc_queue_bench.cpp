@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/container/mpmc_queue.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// even threads produce and odd threads consume, so 2..32 threads mean 1..16 of each
+template<typename Push, typename Pop>
+static void producer_consumer(benchmark::State &state, Push &&push, Pop &&pop) {
+    bool producer = state.thread_index() % 2 == 0;
+    uint64_t value = 0;
+    int64_t popped = 0;
+    for (auto _: state) {
+        if (producer) {
+            push(value++);
+        } else {
+            popped += pop(value);
+        }
+    }
+    benchmark::DoNotOptimize(popped);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// producers drop the value when the queue is full so that the rounds stay bounded
+static void BM_BoundedQueue(benchmark::State &state) {
+    static alp_utils::bounded_queue<uint64_t> queue(1 << 14);
+    producer_consumer(state, [](uint64_t v) { queue.try_push(v); },
+                      [](uint64_t &v) { return queue.try_pop(v); });
+}
+
+BENCHMARK(BM_BoundedQueue)->ThreadRange(2, 32)->UseRealTime();
+
+static void BM_UnboundedQueue(benchmark::State &state) {
+    static alp_utils::unbounded_queue<uint64_t> queue;
+    producer_consumer(state, [](uint64_t v) { queue.push(v); },
+                      [](uint64_t &v) { return queue.try_pop(v); });
+}
+
+BENCHMARK(BM_UnboundedQueue)->ThreadRange(2, 32)->UseRealTime();
+
+static void BM_UnboundedQueueEbr(benchmark::State &state) {
+    static alp_utils::unbounded_queue<uint64_t, 256, alp_utils::ebr_reclamation> queue;
+    producer_consumer(state, [](uint64_t v) { queue.push(v); },
+                      [](uint64_t &v) { return queue.try_pop(v); });
+}
+
+BENCHMARK(BM_UnboundedQueueEbr)->ThreadRange(2, 32)->UseRealTime();
+
+static void BM_MutexDeque(benchmark::State &state) {
+    static std::mutex mutex;
+    static std::deque<uint64_t> queue;
+    producer_consumer(state, [](uint64_t v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(v);
+    }, [](uint64_t &v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            return false;
+        }
+        v = queue.front();
+        queue.pop_front();
+        return true;
+    });
+}
+
+BENCHMARK(BM_MutexDeque)->ThreadRange(2, 32)->UseRealTime();
+
+// moves 32 values per round through the bulk operations
+static constexpr size_t kBatch = 32;
+
+static void BM_BoundedQueueBulk(benchmark::State &state) {
+    static alp_utils::bounded_queue<uint64_t> queue(1 << 14);
+    bool producer = state.thread_index() % 2 == 0;
+    uint64_t values[kBatch] = {};
+    for (auto _: state) {
+        if (producer) {
+            queue.try_push_bulk(values, kBatch);
+        } else {
+            benchmark::DoNotOptimize(queue.try_pop_bulk(values, kBatch));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+BENCHMARK(BM_BoundedQueueBulk)->ThreadRange(2, 32)->UseRealTime();
+
+static void BM_UnboundedQueueBulk(benchmark::State &state) {
+    static alp_utils::unbounded_queue<uint64_t> queue;
+    bool producer = state.thread_index() % 2 == 0;
+    uint64_t values[kBatch] = {};
+    for (auto _: state) {
+        if (producer) {
+            queue.push_bulk(values, values + kBatch);
+        } else {
+            benchmark::DoNotOptimize(queue.try_pop_bulk(values, kBatch));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+BENCHMARK(BM_UnboundedQueueBulk)->ThreadRange(2, 32)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/allocator/pool_allocator.h>
+#include <cpp_utils/container/avl_map.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// inserts kNodes keys in random order and erases them in another random order
+static constexpr int kNodes = 1 << 14;
+
+static const std::vector<int> &shuffled(uint32_t seed) {
+    static std::vector<int> keys[2];
+    auto &k = keys[seed % 2];
+    if (k.empty()) {
+        k.resize(kNodes);
+        std::iota(k.begin(), k.end(), 0);
+        std::shuffle(k.begin(), k.end(), std::mt19937(seed));
+    }
+    return k;
+}
+
+template<typename Map>
+static void BM_MapChurn(benchmark::State &state) {
+    auto &inserts = shuffled(0);
+    auto &erases = shuffled(1);
+    for (auto _: state) {
+        Map map;
+        for (auto key: inserts) {
+            map.emplace(key, key);
+        }
+        for (auto key: erases) {
+            map.erase(key);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kNodes * 2);
+}
+
+template<typename K, typename V>
+using pool_pair = alp_utils::pool_allocator<std::pair<const K, V>>;
+
+BENCHMARK(BM_MapChurn<std::map<int, int>>);
+BENCHMARK(BM_MapChurn<std::map<int, int, std::less<int>, pool_pair<int, int>>>);
+BENCHMARK(BM_MapChurn<alp_utils::avl_map<int, int>>);
+BENCHMARK(BM_MapChurn<alp_utils::avl_map<int, int, std::less<int>, pool_pair<int, int>>>);
+
+// every thread keeps a list and frees its nodes out of allocation order
+template<typename List>
+static void BM_ListChurn(benchmark::State &state) {
+    std::mt19937 gen(state.thread_index());
+    for (auto _: state) {
+        List list;
+        for (int i = 0; i < kNodes; ++i) {
+            if (gen() % 2 == 0) {
+                list.push_back(i);
+            } else {
+                list.push_front(i);
+            }
+        }
+        list.remove_if([](int v) { return v % 3 == 0; });
+        benchmark::DoNotOptimize(list.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kNodes);
+}
+
+BENCHMARK(BM_ListChurn<std::list<int>>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ListChurn<std::list<int, alp_utils::pool_allocator<int>>>)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/rcu_ez.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+// reader scaling of rcu_ez against the atomic<shared_ptr> it replaced, thread 0 keeps publishing
+struct Config {
+    std::array<int64_t, 8> values{};
+};
+
+static int64_t sum(const Config &config) {
+    int64_t sum = 0;
+    for (auto value: config.values) {
+        sum += value;
+    }
+    return sum;
+}
+
+struct ConfigRcu : alp_utils::rcu_ez<Config> {
+    ConfigRcu() { store(); }
+};
+
+static ConfigRcu rcu;
+
+static void BM_RcuEzRead(benchmark::State &state) {
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        for (auto _: state) {
+            rcu.store();
+        }
+        return;
+    }
+    int64_t total = 0;
+    for (auto _: state) {
+        auto config = rcu.load();
+        total += sum(*config);
+    }
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RcuEzRead)->ThreadRange(1, 64)->UseRealTime();
+
+static std::atomic<std::shared_ptr<Config>> shared = std::make_shared<Config>();
+
+static void BM_AtomicSharedPtrRead(benchmark::State &state) {
+    if (state.thread_index() == 0 && state.threads() > 1) {
+        for (auto _: state) {
+            shared.store(std::make_shared<Config>());
+        }
+        return;
+    }
+    int64_t total = 0;
+    for (auto _: state) {
+        auto config = shared.load();
+        total += sum(*config);
+    }
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_AtomicSharedPtrRead)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/sequence_lock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// reader latency percentiles of inline_seq_lock against seq_ring while a writer publishes at 1 MHz
+struct Quote {
+    int64_t bid;
+    int64_t ask;
+    int64_t bid_size;
+    int64_t ask_size;
+    int64_t timestamp;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr auto kWritePeriod = std::chrono::microseconds(1);
+
+template<typename Write, typename Read>
+static void reader_latency(benchmark::State &state, Write &&write, Read &&read) {
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        auto next = Clock::now();
+        for (int64_t i = 0; !done.load(std::memory_order_relaxed); ++i) {
+            write(Quote{i, i, i, i, i});
+            next += kWritePeriod;
+            while (Clock::now() < next) {
+            }
+        }
+    });
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(state.max_iterations);
+    for (auto _: state) {
+        auto start = Clock::now();
+        auto quote = read();
+        auto end = Clock::now();
+        benchmark::DoNotOptimize(quote);
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    done.store(true);
+    writer.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return static_cast<double>(latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))]);
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+    state.counters["max_ns"] = static_cast<double>(latencies.back());
+}
+
+static void BM_InlineSeqLockRead(benchmark::State &state) {
+    alp_utils::inline_seq_lock<Quote> sl;
+    reader_latency(state, [&](const Quote &quote) { sl.store(quote); }, [&] { return sl.load(); });
+}
+
+BENCHMARK(BM_InlineSeqLockRead)->Iterations(1000000);
+
+static void BM_SeqRingRead(benchmark::State &state) {
+    alp_utils::seq_ring<Quote, 4> ring;
+    reader_latency(state, [&](const Quote &quote) { ring.store(quote); }, [&] { return ring.load(); });
+}
+
+BENCHMARK(BM_SeqRingRead)->Iterations(1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/container/avl_map.h>
+#include <cpp_utils/container/skip_list_map.h>
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// 90% lookups, 5% inserts and 5% erases on a map of about kKeys / 2 entries
+static constexpr uint64_t kKeys = 1 << 16;
+
+template<typename Map>
+static void prefill(Map &map) {
+    for (uint64_t key = 0; key < kKeys; key += 2) {
+        map.emplace(key, key);
+    }
+}
+
+template<typename Find, typename Insert, typename Erase>
+static void mixed(benchmark::State &state, Find &&find, Insert &&insert, Erase &&erase) {
+    std::mt19937_64 gen(state.thread_index());
+    int64_t hits = 0;
+    for (auto _: state) {
+        auto r = gen();
+        auto key = r % kKeys;
+        auto op = (r >> 32) % 100;
+        if (op < 90) {
+            hits += find(key);
+        } else if (op < 95) {
+            insert(key);
+        } else {
+            erase(key);
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_SkipListMap(benchmark::State &state) {
+    using Map = alp_utils::skip_list_map<uint64_t, uint64_t>;
+    static Map &map = *[] {
+        auto map = new Map;
+        prefill(*map);
+        return map;
+    }();
+    mixed(state, [](uint64_t key) { return map.contains(key); },
+          [](uint64_t key) { map.emplace(key, key); },
+          [](uint64_t key) { map.erase(key); });
+}
+
+BENCHMARK(BM_SkipListMap)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_MutexAvlMap(benchmark::State &state) {
+    using Map = alp_utils::avl_map<uint64_t, uint64_t>;
+    static std::mutex mutex;
+    static Map &map = *[] {
+        auto map = new Map;
+        prefill(*map);
+        return map;
+    }();
+    mixed(state, [](uint64_t key) {
+              std::lock_guard lock(mutex);
+              return map.find(key) != map.end();
+          },
+          [](uint64_t key) {
+              std::lock_guard lock(mutex);
+              map.emplace(key, key);
+          },
+          [](uint64_t key) {
+              std::lock_guard lock(mutex);
+              map.erase(key);
+          });
+}
+
+BENCHMARK(BM_MutexAvlMap)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include <cpp_utils/concurrency/spin_mutex.h>
+
+#include <cstdint>
+#include <mutex>
+
+// spin_mutex against std::mutex, the argument is the length of the critical section in steps
+template<typename Mutex>
+static void lock_unlock(benchmark::State &state) {
+    static Mutex mutex;
+    static uint64_t shared = 0;
+    auto steps = state.range(0);
+    for (auto _: state) {
+        std::lock_guard lock(mutex);
+        for (int64_t i = 0; i < steps; ++i) {
+            shared = shared * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        benchmark::DoNotOptimize(shared);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_SpinMutex(benchmark::State &state) {
+    lock_unlock<alp_utils::spin_mutex>(state);
+}
+
+BENCHMARK(BM_SpinMutex)->ArgsProduct({{0, 16, 256}})->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_StdMutex(benchmark::State &state) {
+    lock_unlock<std::mutex>(state);
+}
+
+BENCHMARK(BM_StdMutex)->ArgsProduct({{0, 16, 256}})->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
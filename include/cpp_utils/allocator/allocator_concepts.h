@@ -5,6 +5,12 @@
 #include <type_traits>
 
 namespace alp_utils {
+  namespace detail {
+	  // GCC does not accept the member alias template directly in a type requirement
+	  template<typename Alloc, typename U>
+	  using rebind_alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+  } // namespace detail
+
   template<typename Alloc, typename T>
   concept is_std_alloc = requires {
 	  typename Alloc::value_type;
@@ -34,7 +40,7 @@ namespace alp_utils {
 	  };
 
 	  requires requires{
-		  typename std::allocator_traits<Alloc>::template rebind_alloc<int>;
+		  typename detail::rebind_alloc_t<Alloc, int>;
 	  };
   };
 
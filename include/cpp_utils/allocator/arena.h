@@ -1,41 +1,74 @@
 #ifndef ARENA_H
 #define ARENA_H
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <new>
 #include <vector>
 #include <cassert>
 #include <mutex>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace alp_utils {
+  // Block sizes are in bytes. Every new block is growth_factor times larger than the previous
+  // one up to max_block_size, a factor of 1 keeps all blocks at block_size. With huge_pages
+  // blocks are mapped with mmap, rounded up to and aligned at 2 MiB and advised as transparent
+  // huge pages, on other platforms than Linux the option is ignored.
+  struct arena_options {
+	  size_t block_size = 4096;
+	  size_t max_block_size = 64 << 20;
+	  uint32_t growth_factor = 1;
+	  bool huge_pages = false;
+  };
+
   // A simple arena allocator
   // must be used in a single thread
   // must be plain type (no need to destruct)
   class Arena {
   private:
 	  static constexpr int align = (sizeof(void *) > 8) ? sizeof(void *) : 8;
-	  constexpr static int ARENA_BLOCK_SIZE = 4096;
+	  constexpr static size_t HUGE_PAGE_SIZE = 2 << 20;
 
+	  struct block {
+		  char *ptr;
+		  size_t size;
+		  bool mapped;
+	  };
+
+	  arena_options options_;
+	  // size of the next regular block
+	  size_t block_size_;
 	  uint64_t waste_{0};
 	  uint64_t allocs_{0};
+	  uint64_t memory_usage_{0};
 	  char *alloc_ptr{};
 	  char *alloc_aligned_ptr{};
 	  size_t alloc_bytes_remaining;
-	  std::vector<char *> pool;
+	  std::vector<block> pool;
 
 	  void allocate_ptr() {
-		  alloc_ptr = allocate_new_block(ARENA_BLOCK_SIZE);
+		  alloc_ptr = allocate_new_block(block_size_);
+		  // a mapped block may be larger than asked for
+		  auto size = pool.back().size;
+		  if (options_.growth_factor > 1) {
+			  // both are multiples of align, so the aligned end of the next block is aligned too
+			  block_size_ = std::min(block_size_ * options_.growth_factor, options_.max_block_size);
+		  }
 
 		  auto padding = reinterpret_cast<uintptr_t>(alloc_ptr) & (align - 1);
 
-		  alloc_aligned_ptr = alloc_ptr - padding + ARENA_BLOCK_SIZE;
+		  alloc_aligned_ptr = alloc_ptr - padding + size;
 
-		  waste_ += ARENA_BLOCK_SIZE;
-		  alloc_bytes_remaining = ARENA_BLOCK_SIZE - padding;
+		  waste_ += size;
+		  alloc_bytes_remaining = size - padding;
 	  }
 
 	  char *allocate_fall_back(size_t bytes) {
-		  if (bytes > (ARENA_BLOCK_SIZE >> 2)) [[unlikely]] {
+		  if (bytes > (block_size_ >> 2)) [[unlikely]] {
 			  char *result = allocate_new_block(bytes);
 			  return result;
 		  }
@@ -48,7 +81,7 @@ namespace alp_utils {
 	  }
 
 	  char *allocate_align_fallback(size_t bytes) {
-		  if (bytes > (ARENA_BLOCK_SIZE >> 2)) {
+		  if (bytes > (block_size_ >> 2)) {
 			  char *result = allocate_new_block(bytes + align);
 			  return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(result) + align - 1) & ~(align - 1));
 		  }
@@ -61,14 +94,24 @@ namespace alp_utils {
 		  return alloc_aligned_ptr;
 	  }
 
+	  // aligned allocations start at the end of a block, so block sizes are multiples of align
+	  static constexpr size_t round_up(size_t bytes) {
+		  return (bytes + align - 1) & ~static_cast<size_t>(align - 1);
+	  }
+
 	  char *allocate_new_block(size_t bytes);
 
+	  char *map_new_block(size_t bytes);
+
 	  template<typename T>
 	  void deallocate(T *ptr, size_t bytes) {
 		  // do nothing :D
 	  }
 
   public:
+	  // alignment of allocate_aligned
+	  static constexpr size_t alignment = align;
+
 	  uint64_t get_waste() const {
 		  return allocs_;
 	  }
@@ -77,11 +120,33 @@ namespace alp_utils {
 		  return allocs_;
 	  }
 
-	  Arena() : alloc_ptr(nullptr), alloc_aligned_ptr(nullptr), alloc_bytes_remaining(0) {};
+	  // bytes taken from the system, including the unused tails of blocks
+	  uint64_t get_memory_usage() const {
+		  return memory_usage_;
+	  }
+
+	  Arena() : Arena(arena_options{}) {}
+
+	  explicit Arena(const arena_options &options)
+			  : options_(options), block_size_(round_up(std::max<size_t>(options.block_size, align))),
+				alloc_ptr(nullptr), alloc_aligned_ptr(nullptr), alloc_bytes_remaining(0) {
+		  options_.growth_factor = std::max<uint32_t>(options_.growth_factor, 1);
+		  options_.max_block_size = std::max(round_up(options_.max_block_size), block_size_);
+	  }
+
+	  Arena(const Arena &) = delete;
+
+	  Arena &operator=(const Arena &) = delete;
 
 	  ~Arena() {
-		  for (auto &i: pool) {
-			  delete[] i;
+		  for (auto &b: pool) {
+#if defined(__linux__)
+			  if (b.mapped) {
+				  munmap(b.ptr, b.size);
+				  continue;
+			  }
+#endif
+			  delete[] b.ptr;
 		  }
 	  }
 
@@ -105,13 +170,51 @@ namespace alp_utils {
   }
 
   inline char *Arena::allocate_new_block(size_t bytes) {
+#if defined(__linux__)
+	  if (options_.huge_pages) {
+		  return map_new_block(bytes);
+	  }
+#endif
 	  char *result = new char[bytes];
-	  pool.push_back(result);
+	  pool.push_back({result, bytes, false});
+	  memory_usage_ += bytes;
+	  return result;
+  }
+
+  inline char *Arena::map_new_block(size_t bytes) {
+#if defined(__linux__)
+	  auto size = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+	  // transparent huge pages only back 2 MiB aligned ranges, map one huge page more and
+	  // trim the unaligned head and tail
+	  auto raw = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	  if (raw == MAP_FAILED) {
+		  throw std::bad_alloc();
+	  }
+	  auto addr = reinterpret_cast<uintptr_t>(raw);
+	  auto aligned = (addr + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+	  if (aligned != addr) {
+		  munmap(raw, aligned - addr);
+	  }
+	  if (auto tail = HUGE_PAGE_SIZE - (aligned - addr); tail != 0) {
+		  munmap(reinterpret_cast<void *>(aligned + size), tail);
+	  }
+	  // only a hint, the block works without huge pages too
+	  madvise(reinterpret_cast<void *>(aligned), size, MADV_HUGEPAGE);
+
+	  auto result = reinterpret_cast<char *>(aligned);
+	  pool.push_back({result, size, true});
+	  memory_usage_ += size;
 	  return result;
+#else
+	  return nullptr;
+#endif
   }
 
   inline char *Arena::allocate_aligned(size_t bytes) {
 	  // alloc_ptr % align
+	  // aligned allocations are taken from the end of the block, whole multiples of align
+	  // keep the next one aligned too
+	  bytes = (bytes + align - 1) & ~static_cast<size_t>(align - 1);
 	  allocs_ += bytes;
 	  waste_ -= bytes;
 	  if (bytes <= alloc_bytes_remaining) {
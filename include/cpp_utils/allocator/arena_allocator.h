@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "arena.h"
+
+namespace alp_utils {
+  // Stateful STL allocator that takes its memory from an Arena, deallocate does nothing and the
+  // memory is released with the arena. Meant for request scoped containers that are built and
+  // then dropped as a whole, the arena must outlive every container using it and, like the
+  // Arena itself, the containers must stay on a single thread.
+  template<typename T>
+  class arena_allocator {
+  public:
+	  using value_type = T;
+	  using size_type = size_t;
+	  using difference_type = std::ptrdiff_t;
+	  using propagate_on_container_copy_assignment = std::true_type;
+	  using propagate_on_container_move_assignment = std::true_type;
+	  using propagate_on_container_swap = std::true_type;
+	  using is_always_equal = std::false_type;
+
+	  template<typename U>
+	  struct rebind {
+		  using other = arena_allocator<U>;
+	  };
+
+	  explicit arena_allocator(Arena &arena) noexcept: arena_(&arena) {}
+
+	  template<typename U>
+	  arena_allocator(const arena_allocator<U> &other) noexcept : arena_(other.arena()) {}
+
+	  T *allocate(size_t n) {
+		  auto bytes = n * sizeof(T);
+		  if constexpr (alignof(T) <= Arena::alignment) {
+			  return reinterpret_cast<T *>(arena_->allocate_aligned(bytes));
+		  } else {
+			  auto raw = reinterpret_cast<uintptr_t>(arena_->allocate(bytes + alignof(T) - 1));
+			  return reinterpret_cast<T *>((raw + alignof(T) - 1) & ~(alignof(T) - 1));
+		  }
+	  }
+
+	  void deallocate(T *, size_t) noexcept {}
+
+	  Arena *arena() const noexcept { return arena_; }
+
+	  template<typename U>
+	  bool operator==(const arena_allocator<U> &other) const noexcept { return arena_ == other.arena(); }
+
+	  template<typename U>
+	  bool operator!=(const arena_allocator<U> &other) const noexcept { return arena_ != other.arena(); }
+
+  private:
+	  Arena *arena_;
+  };
+} // namespace alp_utils
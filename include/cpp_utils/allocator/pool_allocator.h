@@ -0,0 +1,256 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "arena.h"
+#include "../concurrency/spin_mutex.h"
+
+namespace alp_utils {
+  // Size-class slab allocator for small objects that are freed out of order and from any thread.
+  // Requests are rounded up to a multiple of kGranularity, every class keeps a free list per
+  // thread and one central free list, threads move objects between the two kBatch at a time,
+  // so the central lock is taken once per batch. Slabs are carved out of Arena blocks and are
+  // never given back, freed objects are only reused by requests of the same class. Requests
+  // above kMaxSmall go to operator new.
+  class size_class_pool {
+  public:
+	  static constexpr size_t kGranularity = 16;
+	  static constexpr size_t kMaxSmall = 1024;
+	  static constexpr size_t kClasses = kMaxSmall / kGranularity;
+	  // objects moved between a thread cache and the central list at once
+	  static constexpr size_t kBatch = 32;
+	  static constexpr size_t kSlabBytes = 64 * 1024;
+
+	  static void *allocate(size_t bytes) {
+		  if (bytes > kMaxSmall) [[unlikely]] {
+			  return ::operator new(bytes);
+		  }
+		  if (auto cache = thread_cache::get()) [[likely]] {
+			  return cache->allocate(size_class(bytes));
+		  }
+		  return central_cache::instance().fetch_one(size_class(bytes));
+	  }
+
+	  // bytes must be the size passed to allocate
+	  static void deallocate(void *ptr, size_t bytes) noexcept {
+		  if (bytes > kMaxSmall) [[unlikely]] {
+			  ::operator delete(ptr);
+			  return;
+		  }
+		  if (auto cache = thread_cache::get()) [[likely]] {
+			  cache->deallocate(ptr, size_class(bytes));
+		  } else {
+			  central_cache::instance().release_one(size_class(bytes), ptr);
+		  }
+	  }
+
+  private:
+	  struct free_object {
+		  free_object *next_;
+	  };
+
+	  // a singly linked list of free objects that knows its length
+	  struct free_list {
+		  void push(free_object *obj) noexcept {
+			  obj->next_ = head_;
+			  head_ = obj;
+			  ++size_;
+		  }
+
+		  free_object *pop() noexcept {
+			  auto obj = head_;
+			  head_ = obj->next_;
+			  --size_;
+			  return obj;
+		  }
+
+		  // moves up to count objects from the front of this list to the front of other
+		  size_t move_to(free_list &other, size_t count) noexcept {
+			  size_t moved = 0;
+			  while (moved < count && head_ != nullptr) {
+				  other.push(pop());
+				  ++moved;
+			  }
+			  return moved;
+		  }
+
+		  free_object *head_{nullptr};
+		  size_t size_{0};
+	  };
+
+	  static constexpr size_t size_class(size_t bytes) noexcept {
+		  return bytes == 0 ? 0 : (bytes - 1) / kGranularity;
+	  }
+
+	  static constexpr size_t class_bytes(size_t cls) noexcept { return (cls + 1) * kGranularity; }
+
+	  class central_cache {
+	  public:
+		  // never destroyed, threads may still return objects while statics are torn down
+		  static central_cache &instance() {
+			  static central_cache &cache = *new central_cache;
+			  return cache;
+		  }
+
+		  // fills out with up to kBatch objects of cls
+		  void fetch(size_t cls, free_list &out) {
+			  auto &central = classes_[cls];
+			  std::lock_guard<spin_mutex> lock(central.lock_);
+			  if (central.list_.head_ == nullptr) {
+				  carve_slab(cls, central.list_);
+			  }
+			  central.list_.move_to(out, kBatch);
+		  }
+
+		  void release(size_t cls, free_list &in, size_t count) {
+			  auto &central = classes_[cls];
+			  std::lock_guard<spin_mutex> lock(central.lock_);
+			  in.move_to(central.list_, count);
+		  }
+
+		  // used by threads whose cache is already destroyed
+		  void *fetch_one(size_t cls) {
+			  free_list one;
+			  auto &central = classes_[cls];
+			  std::lock_guard<spin_mutex> lock(central.lock_);
+			  if (central.list_.head_ == nullptr) {
+				  carve_slab(cls, central.list_);
+			  }
+			  central.list_.move_to(one, 1);
+			  return one.head_;
+		  }
+
+		  void release_one(size_t cls, void *ptr) {
+			  auto &central = classes_[cls];
+			  std::lock_guard<spin_mutex> lock(central.lock_);
+			  central.list_.push(static_cast<free_object *>(ptr));
+		  }
+
+	  private:
+		  struct alignas(std::hardware_destructive_interference_size) size_class_list {
+			  spin_mutex lock_;
+			  free_list list_;
+		  };
+
+		  void carve_slab(size_t cls, free_list &out) {
+			  char *slab;
+			  {
+				  // slabs are larger than an Arena block, so each one is a block of its own
+				  // and starts at operator new alignment
+				  std::lock_guard<std::mutex> lock(arena_mutex_);
+				  slab = arena_.allocate(kSlabBytes);
+			  }
+			  auto bytes = class_bytes(cls);
+			  for (auto offset = kSlabBytes - kSlabBytes % bytes; offset >= bytes; offset -= bytes) {
+				  out.push(reinterpret_cast<free_object *>(slab + offset - bytes));
+			  }
+		  }
+
+		  std::array<size_class_list, kClasses> classes_{};
+		  std::mutex arena_mutex_;
+		  Arena arena_;
+	  };
+
+	  class thread_cache {
+	  public:
+		  // nullptr once the cache of this thread is destroyed, other thread_local objects
+		  // may still free memory after that
+		  static thread_cache *get() {
+			  static thread_local thread_cache cache;
+			  return torn_down() ? nullptr : &cache;
+		  }
+
+		  thread_cache() : central_(central_cache::instance()) {}
+
+		  ~thread_cache() {
+			  torn_down() = true;
+			  for (size_t cls = 0; cls < kClasses; ++cls) {
+				  if (lists_[cls].size_ != 0) {
+					  central_.release(cls, lists_[cls], lists_[cls].size_);
+				  }
+			  }
+		  }
+
+		  thread_cache(const thread_cache &) = delete;
+		  thread_cache &operator=(const thread_cache &) = delete;
+
+		  void *allocate(size_t cls) {
+			  auto &list = lists_[cls];
+			  if (list.head_ == nullptr) [[unlikely]] {
+				  central_.fetch(cls, list);
+			  }
+			  return list.pop();
+		  }
+
+		  // keeps at most two batches, so a thread that only frees hands them back in batches
+		  void deallocate(void *ptr, size_t cls) noexcept {
+			  auto &list = lists_[cls];
+			  list.push(static_cast<free_object *>(ptr));
+			  if (list.size_ > 2 * kBatch) [[unlikely]] {
+				  central_.release(cls, list, kBatch);
+			  }
+		  }
+
+	  private:
+		  static bool &torn_down() {
+			  static thread_local bool flag = false;
+			  return flag;
+		  }
+
+		  central_cache &central_;
+		  std::array<free_list, kClasses> lists_{};
+	  };
+  };
+
+  // Stateless STL allocator on top of size_class_pool, usable as Alloc of avl_map, nd_heap and
+  // the standard containers. Types aligned above the pool granularity go to operator new.
+  template<typename T>
+  class pool_allocator {
+  public:
+	  using value_type = T;
+	  using size_type = size_t;
+	  using difference_type = std::ptrdiff_t;
+	  using propagate_on_container_copy_assignment = std::true_type;
+	  using propagate_on_container_move_assignment = std::true_type;
+	  using propagate_on_container_swap = std::true_type;
+	  using is_always_equal = std::true_type;
+
+	  template<typename U>
+	  struct rebind {
+		  using other = pool_allocator<U>;
+	  };
+
+	  pool_allocator() noexcept = default;
+
+	  template<typename U>
+	  pool_allocator(const pool_allocator<U> &) noexcept {}
+
+	  T *allocate(size_t n) {
+		  if constexpr (alignof(T) > size_class_pool::kGranularity) {
+			  return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+		  } else {
+			  return static_cast<T *>(size_class_pool::allocate(n * sizeof(T)));
+		  }
+	  }
+
+	  void deallocate(T *ptr, size_t n) noexcept {
+		  if constexpr (alignof(T) > size_class_pool::kGranularity) {
+			  ::operator delete(ptr, std::align_val_t{alignof(T)});
+		  } else {
+			  size_class_pool::deallocate(ptr, n * sizeof(T));
+		  }
+	  }
+
+	  template<typename U>
+	  bool operator==(const pool_allocator<U> &) const noexcept { return true; }
+
+	  template<typename U>
+	  bool operator!=(const pool_allocator<U> &) const noexcept { return false; }
+  };
+} // namespace alp_utils
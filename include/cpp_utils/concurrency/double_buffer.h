@@ -1,73 +1,265 @@
 #pragma once
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace alp_utils {
+	namespace detail {
+		// Reader count split over cache-line sized stripes, a reader only touches the stripe of
+		// its thread and the writer sums all of them, so readers never share a cache line.
+		class striped_counter {
+		public:
+			static constexpr size_t kStripes = 32;
+
+			std::atomic<int64_t>& local() noexcept {
+				static std::atomic<size_t> next_stripe{0};
+				static thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % kStripes;
+				return stripes_[stripe].count_;
+			}
+
+			bool is_zero() const noexcept {
+				int64_t sum = 0;
+				for (auto& stripe : stripes_) {
+					sum += stripe.count_.load(std::memory_order_seq_cst);
+				}
+				return sum == 0;
+			}
+
+		private:
+			struct alignas(std::hardware_destructive_interference_size) stripe {
+				std::atomic<int64_t> count_{0};
+			};
+
+			std::array<stripe, kStripes> stripes_{};
+		};
+	} // namespace detail
+
+	// Left-Right: readers always find a stable copy and never retry. The writer mutates the
+	// standby copy and publishes it, then toggles the read version, waits for the readers still
+	// on the old copy to leave and applies the same mutation to it. Both copies match again when
+	// a write returns, so a mutation never runs after the call that made it has returned.
 	template <typename T>
 	class double_buffer {
 	public:
-		double_buffer() : current_(0) {
-			buffers_[0].store(std::make_shared<T>(), std::memory_order_relaxed);
-			buffers_[1].store(std::make_shared<T>(), std::memory_order_relaxed);
+		using operation = std::move_only_function<void(T&)>;
+
+		// keeps the buffer it was taken from out of the writer's hands until destroyed
+		class read_handle {
+		public:
+			read_handle(read_handle&& other) noexcept
+				: count_(std::exchange(other.count_, nullptr)), ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+			read_handle& operator=(read_handle&& other) noexcept {
+				if (this != &other) {
+					reset();
+					count_ = std::exchange(other.count_, nullptr);
+					ptr_   = std::exchange(other.ptr_, nullptr);
+				}
+				return *this;
+			}
+
+			read_handle(const read_handle&)			   = delete;
+			read_handle& operator=(const read_handle&) = delete;
+
+			~read_handle() { reset(); }
+
+			const T* get() const noexcept { return ptr_; }
+
+			const T& operator*() const noexcept { return *ptr_; }
+
+			const T* operator->() const noexcept { return ptr_; }
+
+			explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+			void reset() {
+				if (count_ != nullptr) {
+					count_->fetch_sub(1, std::memory_order_release);
+					count_ = nullptr;
+					ptr_   = nullptr;
+				}
+			}
+
+		private:
+			friend class double_buffer;
+
+			read_handle(std::atomic<int64_t>* count, const T* ptr) : count_(count), ptr_(ptr) {}
+
+			std::atomic<int64_t>* count_;
+			const T* ptr_;
+		};
+
+		double_buffer() {
+			buffers_[0] = std::make_unique<T>();
+			buffers_[1] = std::make_unique<T>();
 		}
 
 		template <typename... Args>
-		double_buffer(Args&&... args) : current_(0) {
-			buffers_[0].store(std::make_shared<T>(std::forward<Args>(args)...), std::memory_order_relaxed);
-			buffers_[1].store(std::make_shared<T>(buffers_[0]), std::memory_order_relaxed);
+		double_buffer(Args&&... args) {
+			buffers_[0] = std::make_unique<T>(std::forward<Args>(args)...);
+			buffers_[1] = std::make_unique<T>(*buffers_[0]);
 		}
 
+		// fun is applied to both copies before update returns, so it may capture by reference,
+		// mutations queued by enqueue stay queued until the next flush
 		template <typename Fun>
 		void update(Fun&& fun) {
-			std::unique_lock<std::mutex> lock(mutex_);
-			auto buffers = wait_for_write();
+			std::lock_guard<std::mutex> lock(mutex_);
+			publish(fun);
+		}
 
-			std::forward<Fun>(fun)(buffers);
-			swap();
-			buffers = wait_for_write();
-			std::forward<Fun>(fun)(buffers);
+		// applies all of ops in one swap, readers see none or all of them
+		void update_batch(std::vector<operation> ops) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			apply_batch(ops);
+		}
+
+		// Queues a mutation for the next flush, enqueuing never waits for readers. fun runs in
+		// whichever thread flushes, so what it captures by reference has to outlive that flush.
+		// Once max_pending mutations are queued the enqueuing thread flushes them itself.
+		template <typename Fun>
+		void enqueue(Fun&& fun) {
+			size_t pending = 0;
+			{
+				std::lock_guard<std::mutex> lock(pending_mutex_);
+				pending_.emplace_back(std::forward<Fun>(fun));
+				pending = pending_.size();
+			}
+			auto limit = max_pending_.load(std::memory_order_relaxed);
+			if (limit != 0 && pending >= limit) {
+				flush();
+			}
 		}
 
-		std::shared_ptr<T> read() {
-			auto cur = current_.load(std::memory_order_acquire);
-			auto ptr = buffers_[cur & 1].load(std::memory_order_relaxed);
-
-			// the reason for the while loop is to ensure that
-			// the buffer is swapped out and update before we really load it (means add the reference count)
-			// etc. get cur = 0, then writer swaps to 1 and update 0 cause no one read it, then we load buffer 0 here
-			// I understand it's rare, but it's possible
-			while (cur != current_.load(std::memory_order_acquire)) {
-				cur = current_.load(std::memory_order_acquire);
-				ptr = buffers_[cur & 1].load(std::memory_order_relaxed);
+		// applies every queued mutation in enqueue order, in one swap
+		void flush() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::vector<operation> ops;
+			{
+				std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+				ops.swap(pending_);
 			}
+			apply_batch(ops);
+		}
+
+		// 0 means enqueue never flushes
+		void set_max_pending(size_t limit) { max_pending_.store(limit, std::memory_order_relaxed); }
+
+		size_t pending() {
+			std::lock_guard<std::mutex> lock(pending_mutex_);
+			return pending_.size();
+		}
 
-			return ptr;
+		// wait-free, the handle keeps the copy it was taken from out of the writer's hands
+		read_handle read() {
+			auto version = version_.load(std::memory_order_seq_cst);
+			auto& stripe = readers_[version].local();
+			stripe.fetch_add(1, std::memory_order_seq_cst);
+			return read_handle(&stripe, buffers_[left_right_.load(std::memory_order_seq_cst)].get());
 		}
 
 	private:
-		std::shared_ptr<T> wait_for_write() {
-			auto cur			= next();
-			auto buffers		= buffers_[cur].load(std::memory_order_relaxed);
-			while (buffers.use_count() != 2) {
+		void apply_batch(std::vector<operation>& ops) {
+			if (ops.empty()) {
+				return;
+			}
+			publish([&ops](T& value) {
+				for (auto& op : ops) {
+					op(value);
+				}
+			});
+		}
+
+		// applies fun to the standby copy and publishes it, then applies it to the copy the
+		// readers just left, so both copies are equal again on return
+		template <typename Fun>
+		void publish(Fun&& fun) {
+			fun(standby());
+			swap();
+			toggle_version_and_wait();
+			fun(standby());
+		}
+
+		T& standby() { return *buffers_[1 - left_right_.load(std::memory_order_relaxed)]; }
+
+		// new readers arrive on the other version, so both waits only cover readers that may
+		// have seen the standby copy before the swap
+		void toggle_version_and_wait() {
+			auto prev = version_.load(std::memory_order_relaxed);
+			auto next = 1 - prev;
+			wait_for_readers(next);
+			version_.store(next, std::memory_order_seq_cst);
+			wait_for_readers(prev);
+		}
+
+		void wait_for_readers(uint32_t version) const {
+			while (!readers_[version].is_zero()) {
 				std::this_thread::yield();
 			}
-			return buffers;
 		}
 
-		void swap() { current_.fetch_add(1, std::memory_order_acq_rel); }
+		void swap() { left_right_.store(1 - left_right_.load(std::memory_order_relaxed), std::memory_order_seq_cst); }
 
-		uint64_t current() const { return current_.load(std::memory_order_acquire) & 1; }
+	private:
+		// copy the readers are sent to
+		std::atomic<uint32_t> left_right_{0};
+		// read indicator new readers arrive on
+		std::atomic<uint32_t> version_{0};
+		std::unique_ptr<T> buffers_[2];
+		detail::striped_counter readers_[2];
+		std::mutex mutex_;
+
+		std::mutex pending_mutex_;
+		std::vector<operation> pending_;
+		std::atomic<size_t> max_pending_{0};
+	};
+
+	// Flushes the mutations queued on a double_buffer from a dedicated thread every interval,
+	// and once more when destroyed. Pair it with set_max_pending for a size trigger as well.
+	template <typename T>
+	class batch_flusher {
+	public:
+		batch_flusher(double_buffer<T>& buffer, std::chrono::milliseconds interval)
+			: buffer_(buffer), interval_(interval), worker_([this] { run(); }) {}
 
-		uint64_t next() const { return 1 - current(); }
+		~batch_flusher() {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			cv_.notify_one();
+			worker_.join();
+			buffer_.flush();
+		}
+
+		batch_flusher(const batch_flusher&)			   = delete;
+		batch_flusher& operator=(const batch_flusher&) = delete;
 
 	private:
-		std::atomic<uint64_t> current_;
-		std::atomic<std::shared_ptr<T>> buffers_[2];
+		void run() {
+			std::unique_lock<std::mutex> lock(mutex_);
+			while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+				lock.unlock();
+				buffer_.flush();
+				lock.lock();
+			}
+		}
+
+		double_buffer<T>& buffer_;
+		std::chrono::milliseconds interval_;
 		std::mutex mutex_;
+		std::condition_variable cv_;
+		bool stop_{false};
+		std::thread worker_;
 	};
 
 } // namespace alp_utils
@@ -1,6 +1,306 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "reclamation_detail.h"
+
 namespace alp_utils::ebr {
+    class reclaimer;
+
+    namespace detail {
+        struct retire_node {
+            void reclaim() { reclaim_(this); }
+
+            retire_node *next_{nullptr};
+            void (*reclaim_)(retire_node *){nullptr};
+        };
+
+        // objects one thread retired during one epoch, only touched by that thread
+        struct limbo_list {
+            bool empty() const noexcept { return head_ == nullptr; }
+
+            size_t size() const noexcept { return size_; }
+
+            void push(retire_node *node) noexcept {
+                node->next_ = head_;
+                head_ = node;
+                ++size_;
+            }
+
+            // returns the number of reclaimed objects
+            size_t reclaim() {
+                auto reclaimed = size_;
+                auto node = head_;
+                head_ = nullptr;
+                size_ = 0;
+                while (node != nullptr) {
+                    auto next = node->next_;
+                    node->reclaim();
+                    node = next;
+                }
+                return reclaimed;
+            }
+
+            retire_node *head_{nullptr};
+            size_t size_{0};
+            uint64_t epoch_{0};
+        };
+
+        // Per thread epoch record, state_ holds the announced epoch shifted left by one with
+        // the low bit set while the thread is inside a critical section, 0 when quiescent.
+        struct alignas(std::hardware_destructive_interference_size) thread_record
+                : reclamation_detail::registry_entry<thread_record> {
+            static constexpr uint64_t ACTIVE = 0x1;
+            static constexpr size_t kEpochs = 3;
+
+            std::atomic<uint64_t> state_{0};
+
+            // below are only touched by the owner thread
+            uint32_t nesting_{0};
+            uint32_t retired_{0};
+            std::array<limbo_list, kEpochs> limbo_{};
+        };
+    } // namespace detail
+
+    // Epoch based reclamation: readers announce the global epoch on enter() and retract it on
+    // exit(), the epoch only advances once every thread inside a critical section has seen it.
+    // Objects retired in epoch e are reclaimed once the epoch reaches e + 2, so reading costs a
+    // store and a fence per critical section instead of per pointer, but one stalled reader
+    // holds back reclamation for everyone.
+    class reclaimer {
+        using record = detail::thread_record;
+
+    public:
+        // retires per thread between attempts to advance the epoch
+        static constexpr uint32_t kCollectInterval = 64;
+
+        reclaimer(const reclaimer &) = delete;
+
+        reclaimer &operator=(const reclaimer &) = delete;
+
+        reclaimer(reclaimer &&) = delete;
+
+        reclaimer &operator=(reclaimer &&) = delete;
+
+        ~reclaimer() {
+            orphans_.update([](std::vector<detail::limbo_list> &orphans) {
+                for (auto &orphan: orphans) {
+                    orphan.reclaim();
+                }
+            });
+            for (auto rec = records_.head(); rec != nullptr; rec = rec->next_) {
+                for (auto &limbo: rec->limbo_) {
+                    limbo.reclaim();
+                }
+            }
+        }
+
+        static reclaimer &instance() {
+            static reclaimer instance;
+            return instance;
+        }
+
+        // critical sections nest, only the outermost one announces the epoch
+        void enter() {
+            auto rec = local();
+            if (rec->nesting_++ == 0) {
+                rec->state_.store((epoch_.load(std::memory_order_relaxed) << 1) | record::ACTIVE,
+                                  std::memory_order_relaxed);
+                // the announcement must be visible before any protected load
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        void exit() {
+            auto rec = local();
+            if (--rec->nesting_ == 0) {
+                rec->state_.store(0, std::memory_order_release);
+            }
+        }
+
+        bool in_critical_section() {
+            return local()->nesting_ != 0;
+        }
+
+        uint64_t epoch() const {
+            return epoch_.load(std::memory_order_acquire);
+        }
+
+        template<typename T, typename D = std::default_delete<T>>
+        void retire(T *ptr, D &&deleter = {}) {
+            auto rec = local();
+            // pairs with the fence in try_advance(), the unlink of ptr is ordered before the stamp,
+            // so a reader that still sees ptr holds back the epoch the stamp is taken from
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto epoch = epoch_.load(std::memory_order_acquire);
+            auto &limbo = rec->limbo_[epoch % record::kEpochs];
+            // the list of the same slot is at least kEpochs epochs old
+            if (limbo.epoch_ != epoch) [[unlikely]] {
+                limbo.reclaim();
+                limbo.epoch_ = epoch;
+            }
+            limbo.push(reclamation_detail::make_retire_node<detail::retire_node>(ptr, std::forward<D>(deleter)));
+
+            if (++rec->retired_ >= kCollectInterval) [[unlikely]] {
+                rec->retired_ = 0;
+                collect(rec);
+            }
+        }
+
+        // Best effort: tries to move the epoch far enough to reclaim everything this thread and
+        // exited threads retired. Objects stay in limbo while any thread, including the caller,
+        // is inside a critical section that started before they were retired.
+        void reclaim() {
+            auto rec = local();
+            for (size_t i = 0; i < record::kEpochs; ++i) {
+                try_advance();
+            }
+            collect_limbo(rec);
+            collect_orphans();
+        }
+
+        // objects in limbo of this thread and of exited threads
+        size_t pending() {
+            size_t count = 0;
+            for (auto &limbo: local()->limbo_) {
+                count += limbo.size();
+            }
+            orphans_.update([&count](std::vector<detail::limbo_list> &orphans) {
+                for (auto &orphan: orphans) {
+                    count += orphan.size();
+                }
+            });
+            return count;
+        }
+
+        // returns false if a thread inside a critical section has not seen the current epoch
+        bool try_advance() {
+            // pairs with the fence in enter(), retired objects are unlinked before the scan
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto epoch = epoch_.load(std::memory_order_acquire);
+            for (auto rec = records_.head(); rec != nullptr; rec = rec->next_) {
+                auto state = rec->state_.load(std::memory_order_acquire);
+                if ((state & record::ACTIVE) != 0 && (state >> 1) != epoch) {
+                    return false;
+                }
+            }
+            // a failed CAS means another thread advanced it
+            epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+            return true;
+        }
+
+    private:
+        reclaimer() = default;
+
+        friend class reclamation_detail::record_registry<reclaimer, record>;
+
+        record *local() {
+            return records_.local();
+        }
+
+        // called when the thread that owns rec exits, its limbo lists go to the orphans
+        void release(record *rec) {
+            orphans_.update([rec](std::vector<detail::limbo_list> &orphans) {
+                for (auto &limbo: rec->limbo_) {
+                    if (!limbo.empty()) {
+                        orphans.push_back(std::exchange(limbo, {}));
+                    }
+                }
+            });
+            rec->nesting_ = 0;
+            rec->retired_ = 0;
+            rec->state_.store(0, std::memory_order_release);
+            records_.release(rec);
+        }
+
+        void collect(record *rec) {
+            try_advance();
+            collect_limbo(rec);
+            if (!orphans_.empty()) [[unlikely]] {
+                collect_orphans();
+            }
+        }
+
+        void collect_limbo(record *rec) {
+            auto epoch = epoch_.load(std::memory_order_acquire);
+            for (auto &limbo: rec->limbo_) {
+                if (!limbo.empty() && limbo.epoch_ + 2 <= epoch) {
+                    limbo.reclaim();
+                }
+            }
+        }
+
+        void collect_orphans() {
+            auto ready = orphans_.update([this](std::vector<detail::limbo_list> &orphans) {
+                auto epoch = epoch_.load(std::memory_order_acquire);
+                auto it = std::partition(orphans.begin(), orphans.end(), [epoch](const detail::limbo_list &limbo) {
+                    return limbo.epoch_ + 2 > epoch;
+                });
+                std::vector<detail::limbo_list> ready(it, orphans.end());
+                orphans.erase(it, orphans.end());
+                return ready;
+            });
+            // destructors may retire again, so reclaim outside the lock
+            for (auto &limbo: ready) {
+                limbo.reclaim();
+            }
+        }
+
+        alignas(std::hardware_destructive_interference_size) std::atomic<uint64_t> epoch_{0};
+
+        reclamation_detail::record_registry<reclaimer, record> records_{};
+
+        reclamation_detail::orphan_list<std::vector<detail::limbo_list>> orphans_{};
+    };
+
+    // RAII critical section, pointers loaded through protect stay valid until reset or destruction,
+    // the counterpart of a hazp::hazard_ptr so readers can be written against either scheme
+    class guard {
+    public:
+        guard() { reclaimer::instance().enter(); }
+
+        guard(const guard &) = delete;
+
+        guard &operator=(const guard &) = delete;
+
+        ~guard() { reset(); }
+
+        template<typename T>
+        T *protect(const std::atomic<T *> &ptr) const {
+            return ptr.load(std::memory_order_acquire);
+        }
+
+        void reset() {
+            if (active_) {
+                active_ = false;
+                reclaimer::instance().exit();
+            }
+        }
+
+    private:
+        bool active_{true};
+    };
+
+    static inline void enter() { reclaimer::instance().enter(); }
+
+    static inline void exit() { reclaimer::instance().exit(); }
+
+    static inline guard make_guard() { return {}; }
 
+    template<typename T, typename D = std::default_delete<T>>
+    static inline void retire(T *ptr, D deleter = {}) {
+        reclaimer::instance().retire(ptr, std::move(deleter));
+    }
 
-} // namespace alp
\ No newline at end of file
+    static inline void reclaim() {
+        reclaimer::instance().reclaim();
+    }
+} // namespace alp_utils::ebr
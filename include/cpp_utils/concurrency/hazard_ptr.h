@@ -1,20 +1,95 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <thread>
 #include <unordered_set>
+#include <vector>
+
+#include "reclamation_detail.h"
+
+#if defined(ALP_HAZP_ASYMMETRIC_FENCE) && defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// USDT probes around bulk reclamation, enabled with ALP_HAZP_USDT when <sys/sdt.h> is available
+#if defined(ALP_HAZP_USDT) && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define ALP_HAZP_PROBE2(name, a, b) STAP_PROBE2(alp_hazp, name, a, b)
+#define ALP_HAZP_PROBE3(name, a, b, c) STAP_PROBE3(alp_hazp, name, a, b, c)
+#else
+#define ALP_HAZP_PROBE2(name, a, b) ((void) 0)
+#define ALP_HAZP_PROBE3(name, a, b, c) ((void) 0)
+#endif
 
 namespace alp_utils::hazp {
+    class reclaimer;
+
+    class cohort;
+
+    template<typename T, typename D>
+    class hazptr_obj_base;
+
     namespace detail {
-        // NOTE: m_next_ is used in reclaimer free_list, and local_holder free_list
-        //       next_ is used in reclaimer holder_storage
-        struct holder {
+        // Asymmetric fences: with ALP_HAZP_ASYMMETRIC_FENCE defined, readers (protect) only
+        // issue a compiler barrier and the reclaimer forces a full fence on every running
+        // thread of the process via membarrier before it scans hazard pointers.
+        // Without the macro, or when the kernel lacks the command, both sides use seq_cst fences.
+#if defined(ALP_HAZP_ASYMMETRIC_FENCE) && defined(__linux__)
+        inline bool membarrier_available() noexcept {
+            static const bool available = [] {
+                long cmds = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0);
+                if (cmds < 0 || (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) == 0) {
+                    return false;
+                }
+                return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+            }();
+            return available;
+        }
+#else
+        constexpr bool membarrier_available() noexcept {
+            return false;
+        }
+#endif
+
+        inline void asymmetric_fence_light() noexcept {
+            if (membarrier_available()) [[likely]] {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                return;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        inline void asymmetric_fence_heavy() noexcept {
+#if defined(ALP_HAZP_ASYMMETRIC_FENCE) && defined(__linux__)
+            if (membarrier_available()) {
+                // registered at detection, so the command cannot fail with EPERM here
+                [[maybe_unused]] long ret = syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+                assert(ret == 0);
+                return;
+            }
+#endif
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        // NOTE: m_next_ is used in local_holder free_list
+        // A slot of a block may be reused by any thread, or handed to another thread by a named
+        // domain, so every holder has a cache line of its own and protect never shares its store.
+        struct alignas(std::hardware_destructive_interference_size) holder {
             void set_next(holder *next) noexcept {
                 m_next_.store(next, std::memory_order_relaxed);
             }
@@ -31,21 +106,124 @@ namespace alp_utils::hazp {
                 return m_next_.load(std::memory_order_relaxed);
             }
 
-            void set_main_next(holder *next) noexcept {
-                next_.store(next, std::memory_order_release);
+            static constexpr uintptr_t NOUSE = 0x1;
+            static constexpr uintptr_t INUSE = 0x0;
+
+            // first, so a scan reads the slots of a block at a fixed stride of one line
+            std::atomic<uintptr_t> ptr{INUSE};
+
+            std::atomic<holder *> m_next_{nullptr};
+
+            // the domain whose holder_list_ this holder is linked into
+            reclaimer *domain_{nullptr};
+        };
+
+        // Holders are registered a block at a time, a block is a contiguous array of line sized
+        // holders, so a scan streams through memory instead of chasing a node per holder.
+        struct alignas(std::hardware_destructive_interference_size) holder_block {
+            static constexpr size_t kSlots = 8;
+
+            void set_main_next(holder_block *next) noexcept {
+                next_ = next;
             }
 
-            holder *main_next() const noexcept {
-                return next_.load(std::memory_order_acquire);
+            holder_block *main_next() const noexcept {
+                return next_;
             }
 
-            static constexpr uintptr_t NOUSE = 0x1;
-            static constexpr uintptr_t INUSE = 0x0;
+            std::array<holder, kSlots> slots{};
 
-            std::atomic<holder *> m_next_{nullptr};
+            // written once before the block is published
+            holder_block *next_{nullptr};
+        };
 
-            std::atomic<holder *> next_{nullptr};
-            std::atomic<uintptr_t> ptr{INUSE};
+        // retired and not reclaimed bytes of one shard, pushes to other shards do not touch its line
+        struct alignas(std::hardware_destructive_interference_size) shard_bytes {
+            std::atomic<size_t> bytes{0};
+        };
+
+        // Retire counters of a domain are striped by thread, the sum is only built on read.
+        // A slot is owned by one thread at a time, so its owner updates it with a relaxed load
+        // and store instead of a read-modify-write.
+        struct alignas(std::hardware_destructive_interference_size) stat_slot {
+            void add(uint64_t bytes, bool owned) noexcept {
+                if (owned) [[likely]] {
+                    retired.store(retired.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    retired_bytes.store(retired_bytes.load(std::memory_order_relaxed) + bytes,
+                                        std::memory_order_relaxed);
+                } else {
+                    retired.fetch_add(1, std::memory_order_relaxed);
+                    retired_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                }
+            }
+
+            std::atomic<uint64_t> retired{0};
+            std::atomic<uint64_t> retired_bytes{0};
+        };
+
+        static constexpr uint32_t kOwnedStatSlots = 64;
+
+        // A thread takes a free stat slot index on first use and gives it back when it exits,
+        // threads beyond kOwnedStatSlots share the overflow index kOwnedStatSlots.
+        class stat_slot_owner {
+        public:
+            stat_slot_owner() noexcept {
+                auto owned = mask().load(std::memory_order_relaxed);
+                while (owned != ~uint64_t{0}) {
+                    auto index = static_cast<uint32_t>(std::countr_one(owned));
+                    if (mask().compare_exchange_weak(owned, owned | (uint64_t{1} << index),
+                                                     std::memory_order_acquire, std::memory_order_relaxed)) {
+                        index_ = index;
+                        return;
+                    }
+                }
+            }
+
+            ~stat_slot_owner() {
+                if (index_ != kOwnedStatSlots) {
+                    mask().fetch_and(~(uint64_t{1} << index_), std::memory_order_release);
+                    // retires from later thread_local destructors fall back to the shared slot
+                    index_ = kOwnedStatSlots;
+                }
+            }
+
+            stat_slot_owner(const stat_slot_owner &) = delete;
+
+            stat_slot_owner &operator=(const stat_slot_owner &) = delete;
+
+            uint32_t index() const noexcept { return index_; }
+
+        private:
+            static std::atomic<uint64_t> &mask() noexcept {
+                static std::atomic<uint64_t> owned{0};
+                return owned;
+            }
+
+            uint32_t index_{kOwnedStatSlots};
+        };
+
+        inline uint32_t thread_slot() noexcept {
+            static thread_local stat_slot_owner owner;
+            return owner.index();
+        }
+
+        // Link of a retired object, retire(T*, D) allocates one per object while
+        // hazptr_obj_base embeds it in the object itself.
+        struct retire_node {
+            void set_next(retire_node *next) { next_ = next; }
+
+            retire_node *next() const { return next_; }
+
+            const void *raw_ptr() const { return raw_; }
+
+            void reclaim() { reclaim_(this); }
+
+            retire_node *next_{nullptr};
+            // the address hazard pointers protect
+            const void *raw_{nullptr};
+            void (*reclaim_)(retire_node *){nullptr};
+            // size of the retired object, for the retired bytes limit
+            size_t bytes_{0};
         };
 
         // below two list classes are from folly
@@ -253,75 +431,55 @@ namespace alp_utils::hazp {
             }
         };
 
-        struct read_write_lock {
-        private:
-            static constexpr uint32_t WRITE_LOCK_MASK = 0x80000000;
-            std::atomic<uint32_t> state{0};
-
+        // flat set of protected pointers, filled on each scan and sorted once,
+        // the buffer is kept between scans so a steady state scan does not allocate
+        class hazptr_set {
         public:
-            bool try_lock_shared() {
-                uint32_t expected = state.load(std::memory_order_relaxed);
-                if ((expected & WRITE_LOCK_MASK) == 0) {
-                    uint32_t const desired = expected + 1;
-                    return state.compare_exchange_strong(
-                            expected, desired,
-                            std::memory_order_acquire,
-                            std::memory_order_relaxed
-                    );
-                }
-                return false;
+            void clear() noexcept {
+                vals_.clear();
             }
 
-            bool try_lock() {
-                uint32_t expected = 0;
-                return state.compare_exchange_strong(
-                        expected, WRITE_LOCK_MASK,
-                        std::memory_order_acquire,
-                        std::memory_order_relaxed
-                );
+            void reserve(size_t size) {
+                vals_.reserve(size);
             }
 
-            void lock_shared() {
-                uint32_t expected = state.load(std::memory_order_relaxed);
-                while (true) {
-                    if ((expected & WRITE_LOCK_MASK) == 0) {
-                        uint32_t const desired = expected + 1;
-                        if (state.compare_exchange_weak(
-                                expected, desired,
-                                std::memory_order_acquire,
-                                std::memory_order_relaxed
-                        )) {
-                            break;
-                        }
-                    } else {
-                        std::this_thread::yield();
-                        expected = state.load(std::memory_order_relaxed);
-                    }
-                }
+            void insert(uintptr_t val) {
+                vals_.push_back(val);
             }
 
-            void unlock_shared() {
-                if (state.fetch_sub(1, std::memory_order_release) == 1) {
-                    state.notify_all();
-                }
+            // must be called after the last insert and before any contains
+            void seal() noexcept {
+                std::sort(vals_.begin(), vals_.end());
             }
 
-            void lock() {
-                uint32_t expected = 0;
-                while (!state.compare_exchange_weak(
-                        expected, WRITE_LOCK_MASK,
-                        std::memory_order_acquire,
-                        std::memory_order_relaxed
-                )) {
-                    state.wait(0, std::memory_order_relaxed);
-                    expected = 0;
+            // branch-free binary search, the loop trip count only depends on size
+            // so the compiler lowers the select into a cmov
+            bool contains(const void *ptr) const noexcept {
+                auto key = reinterpret_cast<uintptr_t>(ptr);
+                size_t size = vals_.size();
+                if (size == 0) [[unlikely]] {
+                    return false;
                 }
+
+                const uintptr_t *base = vals_.data();
+                while (size > 1) {
+                    size_t half = size >> 1U;
+                    base = (base[half] <= key) ? base + half : base;
+                    size -= half;
+                }
+                return *base == key;
+            }
+
+            size_t size() const noexcept {
+                return vals_.size();
             }
 
-            void unlock() {
-                state.store(0, std::memory_order_release);
-                state.notify_all();
+            bool empty() const noexcept {
+                return vals_.empty();
             }
+
+        private:
+            std::vector<uintptr_t> vals_;
         };
     } // namespace detail
 
@@ -355,7 +513,7 @@ namespace alp_utils::hazp {
         T *protect(std::atomic<T *> &ptr) {
             while (true) {
                 auto plain_ptr = try_protect(ptr);
-                std::atomic_thread_fence(std::memory_order_seq_cst);
+                detail::asymmetric_fence_light();
                 auto ptr_val = ptr.load(std::memory_order_acquire);
                 if (plain_ptr == ptr_val) [[likely]] {
                     return plain_ptr;
@@ -363,8 +521,36 @@ namespace alp_utils::hazp {
             }
         }
 
+        // protects f(value) for the value loaded from ptr, e.g. a link with its mark bits cleared,
+        // returns the value as loaded
+        template<class T, class Func>
+        T *protect(std::atomic<T *> &ptr, Func &&f) {
+            auto plain_ptr = ptr.load(std::memory_order_acquire);
+            while (true) {
+                holder_->ptr.store(reinterpret_cast<uintptr_t>(f(plain_ptr)), std::memory_order_release);
+                detail::asymmetric_fence_light();
+                auto ptr_val = ptr.load(std::memory_order_acquire);
+                if (plain_ptr == ptr_val) [[likely]] {
+                    return plain_ptr;
+                }
+                plain_ptr = ptr_val;
+            }
+        }
+
+        // ptr must already be protected by another hazard pointer that outlives this protection
+        template<class T>
+        void reset_protection(const T *ptr) {
+            holder_->ptr.store(reinterpret_cast<uintptr_t>(ptr), std::memory_order_release);
+        }
+
         void reset() { unmark(); }
 
+        // exchanges the protected objects without a window in which neither is protected,
+        // lets a traversal move a protection hand over hand
+        friend void swap(hazard_ptr &lhs, hazard_ptr &rhs) noexcept {
+            std::swap(lhs.holder_, rhs.holder_);
+        }
+
     private:
         void unmark() {
             holder_->ptr.store(detail::holder::INUSE, std::memory_order_release);
@@ -374,6 +560,9 @@ namespace alp_utils::hazp {
     template<uint8_t size>
     using hazptr_array = std::array<hazard_ptr, size>;
 
+    // A reclaimer is a reclamation domain: hazard pointers made by a domain only protect
+    // objects retired to the same domain, and a bulk reclaim only scans that domain.
+    // reclaimer::instance() is the default domain, domain<Tag>() gives a named one.
     class reclaimer {
     public:
         reclaimer() = default;
@@ -393,13 +582,20 @@ namespace alp_utils::hazp {
         reclaimer &operator=(reclaimer &&) = delete;
 
     private:
+        using retire_node = detail::retire_node;
+
+        using list = detail::linked_list<retire_node>;
+
         class local_holder final {
         public:
             local_holder() = default;
 
             ~local_holder() {
+                auto &domain = reclaimer::instance();
+                domain.hand_off(retired_);
+                // holders of an exited thread can be taken by any other thread
                 for (auto &node: holder_storage) {
-                    node->ptr.store(detail::holder::NOUSE, std::memory_order_relaxed);
+                    domain.reuse(node);
                 }
                 free_list.clear();
                 holder_storage.clear();
@@ -426,6 +622,12 @@ namespace alp_utils::hazp {
             }
 
             void evict_hazard_ptr() {
+                reclaimer::instance().evictions_.fetch_add(1, std::memory_order_relaxed);
+                release_free();
+            }
+
+            // gives the cached free holders back to the domain, where any thread can take them
+            void release_free() {
                 auto head = free_list.head_;
 
                 while (head != nullptr) {
@@ -441,10 +643,8 @@ namespace alp_utils::hazp {
             }
 
             hazard_ptr get_hazard_ptr() {
-                if (free_list.empty()) {
-                    auto new_holder = instance().make_holder();
-                    holder_storage.emplace(new_holder);
-                    return {new_holder};
+                if (free_list.empty()) [[unlikely]] {
+                    refill();
                 }
 
                 auto hzard_ptr = free_list.pop();
@@ -452,16 +652,8 @@ namespace alp_utils::hazp {
             }
 
             void reserve_hazp(uint8_t size) {
-                auto old_size = free_list.size();
-
-                if (old_size >= size) [[likely]] {
-                    return;
-                }
-
-                for (auto i = old_size; i < size; ++i) {
-                    auto new_holder = instance().make_holder();
-                    free_list.push(new_holder);
-                    holder_storage.emplace(new_holder);
+                while (free_list.size() < size) {
+                    refill();
                 }
             }
 
@@ -469,56 +661,55 @@ namespace alp_utils::hazp {
                 free_list.push(holder);
             }
 
+            // returns the size of the private batch after the push
+            int push_retired(retire_node *node) {
+                retired_.push(node);
+                return retired_.count();
+            }
+
+            void take_retired(list &batch) {
+                batch.splice(retired_);
+            }
+
             static local_holder &get_instance() {
                 static thread_local local_holder instance;
                 return instance;
             }
 
         private:
-            detail::forward_list<detail::holder> free_list{};
-            std::unordered_set<detail::holder *> holder_storage{};
-        };
-
-        struct retire_node {
-            virtual const void *raw_ptr() const { return nullptr; }
-
-            virtual ~retire_node() = default;
-
-            void set_next(retire_node *next) { next_ = next; }
-
-            retire_node *next() const { return next_; }
-
-            retire_node *next_{nullptr};
-        };
-
-        struct free_list : public detail::concurrent_forward_list<detail::holder> {
-            free_list() = default;
-
-            free_list(const free_list &) = delete;
-
-            free_list &operator=(const free_list &) = delete;
-
-            free_list(free_list &&) = delete;
-
-            free_list &operator=(free_list &&) = delete;
-
-            void push(detail::holder *holder) {
-                concurrent_forward_list::push(holder, &detail::holder::set_barrier_next);
+            // slots left by an exited thread first, otherwise a whole block is registered
+            // for this thread, pushed in reverse so it is handed out in address order
+            void refill() {
+                auto &domain = instance();
+                if (auto holder = domain.holder_list_.try_acquire()) {
+                    own(holder);
+                    return;
+                }
+                auto block = domain.make_block();
+                for (auto i = detail::holder_block::kSlots; i-- > 0;) {
+                    own(&block->slots[i]);
+                }
             }
 
-            detail::holder *pop() {
-                return concurrent_forward_list::pop(&detail::holder::barrier_next);
+            void own(detail::holder *holder) {
+                free_list.push(holder);
+                holder_storage.emplace(holder);
             }
 
-            detail::holder *pop_all() {
-                detail::holder *newval = nullptr;
-                return head_.exchange(newval, std::memory_order_acq_rel);
-            }
+            detail::forward_list<detail::holder> free_list{};
+            std::unordered_set<detail::holder *> holder_storage{};
+            // retired objects not yet visible to the reclaimer
+            list retired_{};
         };
 
-        struct holder_list : public detail::concurrent_forward_list<detail::holder> {
+        // Append only: holders are never unlinked while the domain lives, so registration,
+        // scans and reuse never wait for each other. A free holder is marked NOUSE and
+        // taken back with a CAS on its slot.
+        struct holder_list : public detail::concurrent_forward_list<detail::holder_block> {
+            // number of slots, not blocks
             std::atomic<uint32_t> size_{0};
-            mutable detail::read_write_lock rw_lock_{};
+            // free holders, so acquire does not walk the list when there are none
+            std::atomic<uint32_t> free_{0};
 
             holder_list() = default;
 
@@ -531,17 +722,22 @@ namespace alp_utils::hazp {
             holder_list &operator=(holder_list &&) = delete;
 
             ~holder_list() {
-                auto node = head_.load()->next_.load();
-                while (node != nullptr) {
-                    auto next = node->next_.load();
+                if (head_.load() == nullptr) {
+                    return;
+                }
+                auto block = head_.load()->main_next();
+                while (block != nullptr) {
+                    auto next = block->main_next();
 
-                    while (node->ptr.load() != detail::holder::NOUSE) {
-                        std::this_thread::yield();
+                    for (auto &slot: block->slots) {
+                        while (slot.ptr.load() != detail::holder::NOUSE) {
+                            std::this_thread::yield();
+                        }
                     }
 
-                    delete node;
+                    delete block;
 
-                    node = next;
+                    block = next;
                 }
                 delete head_.load();
             }
@@ -550,76 +746,62 @@ namespace alp_utils::hazp {
                 return size_.load(std::memory_order_relaxed);
             }
 
-            void push(detail::holder *holder) {
-                rw_lock_.lock_shared();
-                size_.fetch_add(1, std::memory_order_relaxed);
-                concurrent_forward_list::push(holder, &detail::holder::set_main_next);
-                rw_lock_.unlock_shared();
+            void push(detail::holder_block *block) {
+                size_.fetch_add(detail::holder_block::kSlots, std::memory_order_relaxed);
+                concurrent_forward_list::push(block, &detail::holder_block::set_main_next);
             }
 
-            void compact(detail::holder *compacted_list) {
-                std::unordered_set<detail::holder *> set;
-                while (compacted_list != nullptr) {
-                    set.insert(compacted_list);
-                    compacted_list = compacted_list->next();
-                }
-
-                rw_lock_.lock();
-
-                auto head = head_.load(std::memory_order_acquire);
-                uint32_t size = 0;
-                detail::holder *new_head = nullptr;
+            void release(detail::holder *holder) {
+                holder->ptr.store(detail::holder::NOUSE, std::memory_order_release);
+                free_.fetch_add(1, std::memory_order_release);
+            }
 
-                while (head != nullptr) {
-                    if (!set.contains(head)) {
-                        new_head = head;
-                        size++;
-                        head = head->main_next();
-                        break;
-                    } else {
-                        head = head->main_next();
-                    }
+            detail::holder *try_acquire() {
+                if (free_.load(std::memory_order_acquire) == 0) [[likely]] {
+                    return nullptr;
                 }
-
-                auto tmp = new_head;
-
-                while (head != nullptr) {
-                    if (!set.contains(head)) {
-                        tmp->set_main_next(head);
-                        tmp = head;
-                        size++;
+                for (auto block = head_.load(std::memory_order_acquire); block != nullptr;
+                     block = block->main_next()) {
+                    for (auto &slot: block->slots) {
+                        uintptr_t expected = detail::holder::NOUSE;
+                        if (slot.ptr.load(std::memory_order_relaxed) == expected &&
+                            slot.ptr.compare_exchange_strong(expected, detail::holder::INUSE,
+                                                             std::memory_order_acq_rel,
+                                                             std::memory_order_relaxed)) {
+                            free_.fetch_sub(1, std::memory_order_relaxed);
+                            return &slot;
+                        }
                     }
-                    head = head->main_next();
-                }
-
-                if (tmp != nullptr) {
-                    tmp->set_main_next(nullptr);
-                }
-
-                head_.store(new_head, std::memory_order_release);
-                size_.store(size, std::memory_order_relaxed);
-                rw_lock_.unlock();
-
-                for (auto &node: set) {
-                    delete node;
                 }
+                return nullptr;
             }
         };
 
         using retired_list = detail::shared_head_only_list<retire_node>;
-        using list = detail::linked_list<retire_node>;
 
         constexpr static uint32_t kNumShards = 8;
 
         static constexpr uint32_t kShardMask = kNumShards - 1;
 
-        static constexpr int kReclaimThreshold = 1000;
-
         static constexpr uint64_t kSyncTimePeriod{2000000000}; // nanoseconds
 
+        // 1 hands every retired object to the shared shards immediately
+        static constexpr uint32_t kDefaultRetireBatchSize = 1;
+
         friend class hazard_ptr;
 
+        friend class cohort;
+
+        template<typename T, typename D>
+        friend class hazptr_obj_base;
+
     public:
+        // a bulk reclaim starts once max(min threshold, multiplier * hazard pointers) objects
+        // are retired, so the cost of a scan is amortized over at least multiplier retires per pointer
+        static constexpr int kMinReclaimThreshold = 128;
+
+        static constexpr int kReclaimMultiplier = 2;
+
         static reclaimer &instance() {
             static reclaimer instance;
             return instance;
@@ -629,41 +811,203 @@ namespace alp_utils::hazp {
             get_instance().evict_hazard_ptr();
         }
 
+        // Releases the free holders cached by the calling thread back to the domain, so other
+        // threads reuse them. Holders stay linked until the domain is destroyed so that scans
+        // need no lock, nothing is deleted here. Named domains cache nothing per thread.
         void delete_hazard_ptr() {
-            auto list = free_list_.pop_all();
-            holder_list_.compact(list);
+            if (is_default()) {
+                get_instance().release_free();
+            }
         }
 
         void reuse(detail::holder *holder) {
-            free_list_.push(holder);
+            holder_list_.release(holder);
         }
 
+        // thread cached hazard pointers of the default domain
         static void reserve_hazp(uint8_t size) { return get_instance().reserve_hazp(size); }
 
+        // Member functions since domains exist, reclaimer::make_hazard_ptr() no longer compiles,
+        // use hazp::make_hazard_ptr() or reclaimer::instance().make_hazard_ptr() for the default
+        // domain. Only the default domain has a thread local holder cache, every other domain
+        // takes a free holder with a walk over its holder list, or registers a new block, so
+        // keep hazard pointers of named domains around instead of making one per operation.
         template<uint8_t size>
-        static std::array<hazard_ptr, size> make_hazard_ptr() { return get_instance().get_hazard_ptrs<size>(); }
+        std::array<hazard_ptr, size> make_hazard_ptr() {
+            if (is_default()) [[likely]] {
+                return get_instance().get_hazard_ptrs<size>();
+            }
+            std::array<hazard_ptr, size> hazard_ptrs;
+            for (auto &hzard_ptr: hazard_ptrs) {
+                hzard_ptr = make_holder();
+            }
+            return hazard_ptrs;
+        }
 
-        static hazard_ptr make_hazard_ptr() { return get_instance().get_hazard_ptr(); }
+        hazard_ptr make_hazard_ptr() {
+            if (is_default()) [[likely]] {
+                return get_instance().get_hazard_ptr();
+            }
+            return {make_holder()};
+        }
 
         template<typename T, typename D = std::default_delete<T>>
         void retire(T *ptr, D &&deleter = {}) {
-            struct retire_node_impl : public retire_node {
-                explicit retire_node_impl(std::unique_ptr<T, D> ptr) : ptr_(std::move(ptr)) {}
+            push_retired(make_retire_node(ptr, std::forward<D>(deleter)));
+        }
 
-                const void *raw_ptr() const override { return ptr_.get(); }
+        // Objects are kept in a thread private batch until batch size is reached,
+        // the thread calls reclaim() or exits, so larger batches trade reclaim latency
+        // for a retire path without shared atomics.
+        void set_retire_batch_size(uint32_t size) {
+            retire_batch_size_.store(size == 0 ? 1 : size, std::memory_order_relaxed);
+        }
 
-                ~retire_node_impl() override = default;
+        uint32_t retire_batch_size() const {
+            return retire_batch_size_.load(std::memory_order_relaxed);
+        }
+
+        // Bulk reclamations triggered by retire are handed to the executor instead of
+        // running on the retiring thread, an empty executor restores inline reclamation.
+        // Queued tasks reference this domain, so drain the executor before destroying it.
+        using executor_type = std::function<void(std::function<void()>)>;
+
+        void set_executor(executor_type executor) {
+            if (executor) {
+                executor_.store(std::make_shared<executor_type>(std::move(executor)), std::memory_order_release);
+            } else {
+                executor_.store(nullptr, std::memory_order_release);
+            }
+        }
+
+        // Once more than limit bytes are retired and not reclaimed, retiring threads reclaim
+        // inline even with an executor installed, 0 means no limit. Objects that stay protected
+        // keep the domain over the limit, so after a forced reclaim the next one waits until
+        // another limit / 4 bytes are retired.
+        void set_retired_byte_limit(size_t limit) {
+            byte_limit_.store(limit, std::memory_order_relaxed);
+            next_forced_bytes_.store(0, std::memory_order_relaxed);
+        }
+
+        // Approximate while other threads retire. Kept objects go back to shard 0 while their bytes
+        // stay counted in the shard they were pushed to, so a single shard may wrap around.
+        size_t retired_bytes() const {
+            size_t bytes = 0;
+            for (auto &shard: shard_bytes_) {
+                bytes += shard.bytes.load(std::memory_order_relaxed);
+            }
+            return bytes;
+        }
+
+        void set_reclaim_threshold(int min_threshold, int multiplier = kReclaimMultiplier) {
+            min_threshold_.store(std::max(min_threshold, 1), std::memory_order_relaxed);
+            multiplier_.store(std::max(multiplier, 0), std::memory_order_relaxed);
+        }
+
+        // the retired count that triggers a bulk reclaim, follows the number of hazard pointers
+        int reclaim_threshold() const {
+            auto scaled = static_cast<int64_t>(multiplier_.load(std::memory_order_relaxed)) * holder_list_.size();
+            return static_cast<int>(std::max<int64_t>(min_threshold_.load(std::memory_order_relaxed), scaled));
+        }
 
-                std::unique_ptr<T, D> ptr_;
-            };
+        // objects retired for longer than period are reclaimed even below the threshold
+        void set_sync_period(std::chrono::nanoseconds period) {
+            sync_period_.store(static_cast<uint64_t>(period.count()), std::memory_order_relaxed);
+            set_due_time();
+        }
 
-            auto unique_ptr = std::unique_ptr<T, D>(ptr, std::forward<D>(deleter));
+        struct scan_counters {
+            uint64_t scans{0};
+            uint64_t reclaimed{0};
+            uint64_t kept{0};
+            // of the latest bulk reclaim
+            uint64_t last_reclaimed{0};
+            uint64_t last_kept{0};
+        };
 
-            auto retired = new retire_node_impl(std::move(unique_ptr));
-            push_list(retired);
+        // one per owning thread and the shared overflow slot
+        static constexpr size_t kStatSlots = detail::kOwnedStatSlots + 1;
+
+        // bucket i counts bulk reclaims that took [2^(i-1), 2^i) microseconds, the last is open ended
+        static constexpr size_t kScanHistogramBuckets = 16;
+
+        struct reclaim_stats {
+            uint64_t retired{0};
+            // retired, including thread private batches, and not reclaimed yet
+            uint64_t unreclaimed{0};
+            uint64_t unreclaimed_bytes{0};
+            uint64_t bulk_reclaims{0};
+            uint32_t holders_allocated{0};
+            // returned to the domain or left by exited threads
+            uint32_t holders_free{0};
+            uint32_t holders_protecting{0};
+            uint64_t evictions{0};
+            std::array<uint64_t, kScanHistogramBuckets> scan_duration{};
+        };
+
+        // hot path counters are per thread, so this walks every slot and the holder list
+        reclaim_stats stats() const {
+            reclaim_stats stats;
+            // reclaimed before retired, so unreclaimed does not underflow
+            auto reclaimed = reclaimed_.load(std::memory_order_acquire);
+            auto reclaimed_bytes = reclaimed_bytes_.load(std::memory_order_acquire);
+            uint64_t retired_bytes = 0;
+            for (auto &slot: stat_slots_) {
+                stats.retired += slot.retired.load(std::memory_order_acquire);
+                retired_bytes += slot.retired_bytes.load(std::memory_order_acquire);
+            }
+            stats.unreclaimed = stats.retired > reclaimed ? stats.retired - reclaimed : 0;
+            stats.unreclaimed_bytes = retired_bytes > reclaimed_bytes ? retired_bytes - reclaimed_bytes : 0;
+            stats.bulk_reclaims = bulk_reclaims_.load(std::memory_order_relaxed);
+            stats.evictions = evictions_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < kScanHistogramBuckets; ++i) {
+                stats.scan_duration[i] = scan_duration_[i].load(std::memory_order_relaxed);
+            }
+
+            for (auto block = holder_list_.head_.load(std::memory_order_acquire); block != nullptr;
+                 block = block->main_next()) {
+                for (auto &slot: block->slots) {
+                    auto ptr = slot.ptr.load(std::memory_order_relaxed);
+                    stats.holders_allocated++;
+                    if (ptr == detail::holder::NOUSE) {
+                        stats.holders_free++;
+                    } else if (ptr != detail::holder::INUSE) {
+                        stats.holders_protecting++;
+                    }
+                }
+            }
+            return stats;
         }
 
+        enum class trace_point {
+            reclaim_begin, // value is the retired count that triggered it
+            reclaim_end,   // value is the duration in nanoseconds
+        };
+
+        using trace_hook = void (*)(const reclaimer &domain, trace_point point, uint64_t value);
+
+        // called around every bulk reclaim on the reclaiming thread, nullptr disables it
+        void set_trace_hook(trace_hook hook) {
+            trace_hook_.store(hook, std::memory_order_release);
+        }
+
+        // updated once per scan, never on retire
+        scan_counters counters() const {
+            scan_counters counters;
+            counters.scans = scans_.load(std::memory_order_relaxed);
+            counters.reclaimed = reclaimed_.load(std::memory_order_relaxed);
+            counters.kept = kept_.load(std::memory_order_relaxed);
+            counters.last_reclaimed = last_reclaimed_.load(std::memory_order_relaxed);
+            counters.last_kept = last_kept_.load(std::memory_order_relaxed);
+            return counters;
+        }
+
+        // only the calling thread's private batch is flushed
         void reclaim() {
+            if (is_default()) {
+                flush_retired();
+            }
+
             inc_num_bulk_reclaims();
             do_reclamation(0);
 
@@ -671,26 +1015,52 @@ namespace alp_utils::hazp {
         }
 
     private:
-        detail::holder *make_new_holder() {
-            auto holder = new detail::holder();
-            holder_list_.push(holder);
-            return holder;
+        template<typename T, typename D>
+        static retire_node *make_retire_node(T *ptr, D &&deleter) {
+            auto node = reclamation_detail::make_retire_node<retire_node>(ptr, std::forward<D>(deleter));
+            node->raw_ = ptr;
+            node->bytes_ = sizeof(T);
+            return node;
+        }
+
+        bool is_default() const { return this == &instance(); }
+
+        // give a holder back to its domain, holders of the default domain go to the thread cache
+        static void release(detail::holder *holder) {
+            if (holder->domain_->is_default()) [[likely]] {
+                get_instance().reuse(holder);
+            } else {
+                holder->domain_->reuse(holder);
+            }
+        }
+
+        // all slots of a new block start owned (INUSE) by the caller
+        detail::holder_block *make_block() {
+            auto block = new detail::holder_block();
+            for (auto &slot: block->slots) {
+                slot.domain_ = this;
+            }
+            holder_list_.push(block);
+            return block;
         }
 
         detail::holder *make_holder() {
-            if (!free_list_.empty()) [[unlikely]] {
-                auto holder = free_list_.pop();
-                return holder ? holder : make_new_holder();
+            if (auto holder = holder_list_.try_acquire()) {
+                return holder;
+            }
+            auto block = make_block();
+            for (size_t i = 1; i < detail::holder_block::kSlots; ++i) {
+                holder_list_.release(&block->slots[i]);
             }
-            return make_new_holder();
+            return &block->slots[0];
         }
 
         static local_holder &get_instance() { return local_holder::get_instance(); }
 
         void reclaim_all_objects() {
-            for (auto &s: retired_list_) {
-                retire_node *head = s.pop_all();
-                reclaim_obj(head);
+            for (uint32_t s = 0; s < kNumShards; ++s) {
+                retire_node *head = retired_list_[s].pop_all();
+                sub_bytes(s, reclaim_obj(head));
             }
         }
 
@@ -699,7 +1069,7 @@ namespace alp_utils::hazp {
                     std::chrono::steady_clock::now().time_since_epoch())
                     .count();
             auto due = load_due_time();
-            if (time < due || !cas_due_time(due, time + kSyncTimePeriod)) {
+            if (time < due || !cas_due_time(due, time + sync_period_.load(std::memory_order_relaxed))) {
                 return 0;
             }
             int const rcount = exchange_count(0);
@@ -711,16 +1081,52 @@ namespace alp_utils::hazp {
         }
 
         void check_threshold_and_reclaim() {
+            bool const forced = claim_forced_reclaim();
             int rcount = check_count_threshold();
             if (rcount == 0) {
                 rcount = check_due_time();
-                if (rcount == 0) {
+                if (rcount == 0 && !forced) {
                     return;
                 }
             }
 
             inc_num_bulk_reclaims();
+            if (!forced && try_offload(rcount)) {
+                return;
+            }
             do_reclamation(rcount);
+            if (forced) {
+                auto step = forced_step(byte_limit_.load(std::memory_order_relaxed));
+                next_forced_bytes_.store(retired_bytes() + step, std::memory_order_relaxed);
+            }
+        }
+
+        static constexpr size_t forced_step(size_t limit) {
+            return std::max<size_t>(limit >> 2, 1);
+        }
+
+        // true for the one thread that reclaims inline for the current step over the byte limit
+        bool claim_forced_reclaim() {
+            auto limit = byte_limit_.load(std::memory_order_relaxed);
+            if (limit == 0) [[likely]] {
+                return false;
+            }
+            auto bytes = retired_bytes();
+            auto next = next_forced_bytes_.load(std::memory_order_relaxed);
+            if (bytes <= limit || bytes < next) {
+                return false;
+            }
+            return next_forced_bytes_.compare_exchange_strong(next, bytes + forced_step(limit),
+                                                              std::memory_order_relaxed);
+        }
+
+        bool try_offload(int rcount) {
+            auto executor = executor_.load(std::memory_order_acquire);
+            if (!executor) [[likely]] {
+                return false;
+            }
+            (*executor)([this, rcount] { do_reclamation(rcount); });
+            return true;
         }
 
         template<typename Cond>
@@ -748,49 +1154,75 @@ namespace alp_utils::hazp {
             return true;
         }
 
-        void reclaim_obj(retire_node *obj) {
+        // returns the bytes of the reclaimed objects
+        size_t reclaim_obj(retire_node *obj) {
+            size_t bytes = 0;
             while (obj != nullptr) {
                 auto next = obj->next();
-                delete obj;
+                bytes += obj->bytes_;
+                obj->reclaim();
                 obj = next;
             }
+            return bytes;
         }
 
         int
-        match_reclaim(std::array<retire_node *, kNumShards> retired, std::unordered_set<const void *> &hash_set,
+        match_reclaim(std::array<retire_node *, kNumShards> retired, const detail::hazptr_set &protected_ptrs,
                       bool &done) {
             done = true;
             list not_reclaimed;
             int count = 0;
-            for (auto &retire_nodes: retired) {
+            size_t freed_bytes = 0;
+            for (uint32_t s = 0; s < kNumShards; ++s) {
+                auto retire_nodes = retired[s];
                 list match;
                 list nomatch;
                 list_match_condition(retire_nodes, match, nomatch,
-                                     [&](retire_node *obj) { return hash_set.contains(obj->raw_ptr()); });
+                                     [&](retire_node *obj) { return protected_ptrs.contains(obj->raw_ptr()); });
                 count += nomatch.count();
 
-                reclaim_obj(nomatch.head());
+                auto bytes = reclaim_obj(nomatch.head());
+                sub_bytes(s, bytes);
+                freed_bytes += bytes;
                 if (!retired_list_empty()) {
                     done = false;
                 }
                 not_reclaimed.splice(match);
             }
 
-            list remain_list(not_reclaimed.head(), not_reclaimed.tail());
-            retired_list_[0].push_list(remain_list);
+            record_scan(count, not_reclaimed.count(), freed_bytes);
+            retired_list_[0].push_list(not_reclaimed);
             return count;
         }
 
+        void record_scan(int reclaimed, int kept, size_t reclaimed_bytes) {
+            scans_.fetch_add(1, std::memory_order_relaxed);
+            reclaimed_bytes_.fetch_add(reclaimed_bytes, std::memory_order_release);
+            reclaimed_.fetch_add(reclaimed, std::memory_order_release);
+            kept_.fetch_add(kept, std::memory_order_relaxed);
+            last_reclaimed_.store(reclaimed, std::memory_order_relaxed);
+            last_kept_.store(kept, std::memory_order_relaxed);
+        }
+
         void do_reclamation(int rcount) {
             assert(rcount >= 0);
 
+            auto &protected_ptrs = scan_buffer();
+            auto hook = trace_hook_.load(std::memory_order_acquire);
+            auto start = std::chrono::steady_clock::now();
+            bulk_reclaims_.fetch_add(1, std::memory_order_relaxed);
+            ALP_HAZP_PROBE2(reclaim_begin, this, rcount);
+            if (hook != nullptr) [[unlikely]] {
+                hook(*this, trace_point::reclaim_begin, static_cast<uint64_t>(rcount));
+            }
+
             while (true) {
                 std::array<retire_node *, kNumShards> retired{};
                 bool done = true;
                 if (extract_retired_objects(retired)) {
-                    std::atomic_thread_fence(std::memory_order_seq_cst);
-                    std::unordered_set<const void *> hash_set = load_hazptr_vals();
-                    rcount -= match_reclaim(retired, hash_set, done);
+                    detail::asymmetric_fence_heavy();
+                    load_hazptr_vals(protected_ptrs);
+                    rcount -= match_reclaim(retired, protected_ptrs, done);
                 }
 
                 if (rcount != 0) {
@@ -802,9 +1234,56 @@ namespace alp_utils::hazp {
                     break;
                 }
             }
+
+            auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            record_scan_duration(static_cast<uint64_t>(duration));
+            ALP_HAZP_PROBE3(reclaim_end, this, duration, load_count());
+            if (hook != nullptr) [[unlikely]] {
+                hook(*this, trace_point::reclaim_end, static_cast<uint64_t>(duration));
+            }
             dec_num_bulk_reclaims();
         }
 
+        void record_scan_duration(uint64_t nanoseconds) {
+            auto bucket = std::min<size_t>(std::bit_width(nanoseconds / 1000), kScanHistogramBuckets - 1);
+            scan_duration_[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void count_retired(size_t bytes) {
+            auto index = detail::thread_slot();
+            stat_slots_[index].add(bytes, index != detail::kOwnedStatSlots);
+        }
+
+        // several threads may reclaim at once, so the scan buffer is per thread
+        static detail::hazptr_set &scan_buffer() {
+            static thread_local detail::hazptr_set protected_ptrs;
+            return protected_ptrs;
+        }
+
+        // reclaim the unprotected objects of a list kept outside the shards, the rest is pushed back
+        int reclaim_list(retired_list &retired) {
+            retire_node *head = retired.pop_all();
+            if (head == nullptr) {
+                return 0;
+            }
+
+            auto &protected_ptrs = scan_buffer();
+            detail::asymmetric_fence_heavy();
+            load_hazptr_vals(protected_ptrs);
+
+            list match;
+            list nomatch;
+            list_match_condition(head, match, nomatch,
+                                 [&](retire_node *obj) { return protected_ptrs.contains(obj->raw_ptr()); });
+            // destructors may retire into the same list
+            retired.push_list(match);
+            auto count = nomatch.count();
+            auto bytes = reclaim_obj(nomatch.head());
+            record_scan(count, match.count(), bytes);
+            return count;
+        }
+
         bool extract_retired_objects(std::array<retire_node *, kNumShards> &list) {
             bool empty = true;
 
@@ -819,7 +1298,8 @@ namespace alp_utils::hazp {
 
         int check_count_threshold() {
             int rcount = load_count();
-            while (rcount >= kReclaimThreshold) {
+            int const threshold = reclaim_threshold();
+            while (rcount >= threshold) {
                 if (cas_count(rcount, 0)) {
                     return rcount;
                 }
@@ -827,28 +1307,31 @@ namespace alp_utils::hazp {
             return 0;
         }
 
-        [[nodiscard]] std::unordered_set<const void *> load_hazptr_vals() const {
-            holder_list_.rw_lock_.lock_shared();
-            auto head = holder_list_.head_.load(std::memory_order_acquire);
-            // std::unordered_set is slower than what I can imagine :(
-            std::unordered_set<const void *> protected_ptrs;
-
+        void load_hazptr_vals(detail::hazptr_set &protected_ptrs) const {
+            protected_ptrs.clear();
             protected_ptrs.reserve(holder_list_.size());
 
-            while (head != nullptr) {
-                auto ptr = head->ptr.load(std::memory_order_acquire);
-
-                if (ptr == detail::holder::NOUSE || ptr == detail::holder::INUSE) {
-                    head = head->next_.load(std::memory_order_acquire);
-                    continue;
+            for (auto block = holder_list_.head_.load(std::memory_order_acquire); block != nullptr;
+                 block = block->main_next()) {
+                for (auto &slot: block->slots) {
+                    auto ptr = slot.ptr.load(std::memory_order_acquire);
+                    if (ptr != detail::holder::NOUSE && ptr != detail::holder::INUSE) {
+                        protected_ptrs.insert(ptr);
+                    }
                 }
-
-                protected_ptrs.insert(reinterpret_cast<const void *>(ptr));
-                head = head->next_.load(std::memory_order_acquire);
             }
-            holder_list_.rw_lock_.unlock_shared();
 
-            return protected_ptrs;
+            protected_ptrs.seal();
+        }
+
+        void add_bytes(uint32_t shard, size_t bytes) {
+            shard_bytes_[shard].bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void sub_bytes(uint32_t shard, size_t bytes) {
+            if (bytes != 0) {
+                shard_bytes_[shard].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            }
         }
 
         int add_count(int rcount) { return count_.fetch_add(rcount, std::memory_order_release); }
@@ -868,7 +1351,7 @@ namespace alp_utils::hazp {
             uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
                     std::chrono::steady_clock::now().time_since_epoch())
                     .count();
-            due_time_.store(time + kSyncTimePeriod, std::memory_order_release);
+            due_time_.store(time + sync_period_.load(std::memory_order_relaxed), std::memory_order_release);
         }
 
         bool cas_due_time(uint64_t &expected, uint64_t newval) {
@@ -879,14 +1362,71 @@ namespace alp_utils::hazp {
 
         void push_list(retire_node *ptr) {
             // NOTE: 4 bit may already skip the empty bits.
-            auto hash = reinterpret_cast<uintptr_t>(ptr) >> 8U;
-            std::atomic_thread_fence(std::memory_order_seq_cst);
-            retired_list_[hash & kShardMask].push(ptr);
+            auto shard = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(ptr) >> 8U) & kShardMask;
+            // read before the push, the node may be reclaimed right after it
+            auto bytes = ptr->bytes_;
+            detail::asymmetric_fence_light();
+            retired_list_[shard].push(ptr);
+            add_bytes(shard, bytes);
             add_count(1);
 
             check_threshold_and_reclaim();
         }
 
+        void push_list(list &batch) {
+            if (batch.empty()) {
+                return;
+            }
+            hand_off(batch);
+
+            check_threshold_and_reclaim();
+        }
+
+        // publish a private batch to the shared shards without triggering a reclamation
+        void hand_off(list &batch) {
+            if (batch.empty()) {
+                return;
+            }
+            auto count = batch.count();
+            size_t bytes = 0;
+            for (auto node = batch.head(); node != nullptr; node = node->next()) {
+                bytes += node->bytes_;
+            }
+            auto shard = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(batch.head()) >> 8U) & kShardMask;
+            detail::asymmetric_fence_light();
+            retired_list_[shard].push_list(batch);
+            batch.clear();
+            add_bytes(shard, bytes);
+            add_count(count);
+        }
+
+        void push_retired(retire_node *ptr) {
+            count_retired(ptr->bytes_);
+            auto batch_size = retire_batch_size();
+            if (batch_size <= 1) [[likely]] {
+                push_list(ptr);
+                return;
+            }
+
+            if (!is_default()) {
+                push_list(ptr);
+                return;
+            }
+
+            auto &local = get_instance();
+            if (local.push_retired(ptr) >= static_cast<int>(batch_size)) {
+                list batch;
+                local.take_retired(batch);
+                push_list(batch);
+            }
+        }
+
+        void flush_retired() {
+            list batch;
+            get_instance().take_retired(batch);
+            push_list(batch);
+        }
+
         uint16_t load_num_bulk_reclaims() {
             return num_bulk_reclaims_.load(std::memory_order_acquire);
         }
@@ -908,8 +1448,6 @@ namespace alp_utils::hazp {
 
         holder_list holder_list_{};
 
-        free_list free_list_{};
-
         std::atomic<int> count_{0};
         std::atomic<uint64_t> due_time_{0};
 
@@ -917,6 +1455,31 @@ namespace alp_utils::hazp {
         std::array<retired_list, kNumShards> retired_list_{};
 
         std::atomic<uint16_t> num_bulk_reclaims_{0};
+
+        std::atomic<uint32_t> retire_batch_size_{kDefaultRetireBatchSize};
+
+        std::atomic<std::shared_ptr<executor_type>> executor_{};
+        std::array<detail::shard_bytes, kNumShards> shard_bytes_{};
+        std::atomic<size_t> byte_limit_{0};
+        // retired bytes at which the next forced reclaim may start
+        std::atomic<size_t> next_forced_bytes_{0};
+
+        std::atomic<int> min_threshold_{kMinReclaimThreshold};
+        std::atomic<int> multiplier_{kReclaimMultiplier};
+        std::atomic<uint64_t> sync_period_{kSyncTimePeriod};
+
+        std::atomic<uint64_t> scans_{0};
+        std::atomic<uint64_t> reclaimed_{0};
+        std::atomic<uint64_t> kept_{0};
+        std::atomic<uint64_t> last_reclaimed_{0};
+        std::atomic<uint64_t> last_kept_{0};
+        std::atomic<uint64_t> reclaimed_bytes_{0};
+
+        std::array<detail::stat_slot, kStatSlots> stat_slots_{};
+        std::atomic<uint64_t> bulk_reclaims_{0};
+        std::atomic<uint64_t> evictions_{0};
+        std::array<std::atomic<uint64_t>, kScanHistogramBuckets> scan_duration_{};
+        std::atomic<trace_hook> trace_hook_{nullptr};
     };
 
     hazard_ptr &hazard_ptr::operator=(hazard_ptr &&other) noexcept {
@@ -926,7 +1489,7 @@ namespace alp_utils::hazp {
 
         if (holder_ != nullptr) [[unlikely]] {
             unmark();
-            reclaimer::get_instance().reuse(holder_);
+            reclaimer::release(holder_);
             holder_ = nullptr;
         }
 
@@ -941,7 +1504,7 @@ namespace alp_utils::hazp {
         }
 
         unmark();
-        reclaimer::get_instance().reuse(holder_);
+        reclaimer::release(holder_);
     }
 
 
@@ -951,21 +1514,26 @@ namespace alp_utils::hazp {
     template<uint8_t size>
     static inline std::array<hazard_ptr, size> make_hazard_ptr() {
         static_assert(size > 0, "size must be greater than 0");
-        return reclaimer::make_hazard_ptr<size>();
+        return reclaimer::instance().make_hazard_ptr<size>();
     }
 
-    static inline hazard_ptr make_hazard_ptr() { return reclaimer::make_hazard_ptr(); }
+    static inline hazard_ptr make_hazard_ptr() { return reclaimer::instance().make_hazard_ptr(); }
 
     // retire the object
     template<typename T, typename D = std::default_delete<T>>
     static inline void retire(T *ptr, D deleter = {}) {
-        reclaimer::instance().retire(ptr, deleter);
+        reclaimer::instance().retire(ptr, std::move(deleter));
     }
 
     static inline void reclaim() {
         reclaimer::instance().reclaim();
     }
 
+    // number of objects a thread retires privately before handing them to the reclaimer
+    static inline void set_retire_batch_size(uint32_t size) {
+        reclaimer::instance().set_retire_batch_size(size);
+    }
+
     static inline void evict_hazard_ptr() {
         reclaimer::instance().evict_hazard_ptr();
     }
@@ -974,13 +1542,189 @@ namespace alp_utils::hazp {
         reclaimer::instance().delete_hazard_ptr();
     }
 
+    // Runs the bulk reclamations of a domain on a dedicated thread, retiring threads only
+    // enqueue work. Installs itself as the domain's executor until it is destroyed.
+    class background_reclaimer {
+        // shared with the executor, a retiring thread may still hold it after we are gone
+        struct task_queue {
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            std::deque<std::function<void()>> tasks_;
+            bool stop_{false};
+
+            void enqueue(std::function<void()> task) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (stop_) [[unlikely]] {
+                    // every task holds a bulk reclaim count, so it must run somewhere
+                    lock.unlock();
+                    task();
+                    return;
+                }
+                tasks_.push_back(std::move(task));
+                lock.unlock();
+                cv_.notify_one();
+            }
+        };
+
+    public:
+        explicit background_reclaimer(reclaimer &domain = reclaimer::instance()) :
+                domain_(domain), queue_(std::make_shared<task_queue>()), worker_([this] { run(); }) {
+            domain_.set_executor([queue = queue_](std::function<void()> task) { queue->enqueue(std::move(task)); });
+        }
+
+        ~background_reclaimer() {
+            domain_.set_executor(nullptr);
+            {
+                std::lock_guard<std::mutex> lock(queue_->mutex_);
+                queue_->stop_ = true;
+            }
+            queue_->cv_.notify_one();
+            worker_.join();
+        }
+
+        background_reclaimer(const background_reclaimer &) = delete;
+
+        background_reclaimer &operator=(const background_reclaimer &) = delete;
+
+        background_reclaimer(background_reclaimer &&) = delete;
+
+        background_reclaimer &operator=(background_reclaimer &&) = delete;
+
+    private:
+        void run() {
+            auto &queue = *queue_;
+            std::unique_lock<std::mutex> lock(queue.mutex_);
+            while (true) {
+                queue.cv_.wait(lock, [&queue] { return queue.stop_ || !queue.tasks_.empty(); });
+                // drain before stopping
+                if (queue.tasks_.empty()) {
+                    return;
+                }
+                auto task = std::move(queue.tasks_.front());
+                queue.tasks_.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+
+        reclaimer &domain_;
+        std::shared_ptr<task_queue> queue_;
+        std::thread worker_;
+    };
+
+    // a process wide domain per tag type, not static so every translation unit shares it
+    template<typename Tag>
+    inline reclaimer &domain() {
+        static reclaimer instance;
+        return instance;
+    }
+
+    // Objects retired to a cohort stay out of the domain's shards, so the domain's bulk
+    // reclaims never scan them, and all of them are reclaimed before the cohort is destroyed.
+    // The cohort must not outlive its domain.
+    class cohort {
+    public:
+        explicit cohort(reclaimer &domain = reclaimer::instance()) : domain_(domain) {}
+
+        ~cohort() {
+            // wait until every hazard pointer of the domain released the cohort's objects
+            domain_.reclaim_list(retired_);
+            while (!retired_.empty()) {
+                std::this_thread::yield();
+                domain_.reclaim_list(retired_);
+            }
+        }
+
+        cohort(const cohort &) = delete;
+
+        cohort &operator=(const cohort &) = delete;
+
+        cohort(cohort &&) = delete;
+
+        cohort &operator=(cohort &&) = delete;
+
+        template<typename T, typename D = std::default_delete<T>>
+        void retire(T *ptr, D &&deleter = {}) {
+            push_retired(reclaimer::make_retire_node(ptr, std::forward<D>(deleter)));
+        }
+
+        void reclaim() {
+            count_.store(0, std::memory_order_relaxed);
+            domain_.reclaim_list(retired_);
+        }
+
+        reclaimer &domain() const { return domain_; }
+
+    private:
+        template<typename T, typename D>
+        friend class hazptr_obj_base;
+
+        void push_retired(detail::retire_node *node) {
+            domain_.count_retired(node->bytes_);
+            detail::asymmetric_fence_light();
+            retired_.push(node);
+
+            int const threshold = domain_.reclaim_threshold();
+            if (count_.fetch_add(1, std::memory_order_acq_rel) + 1 >= threshold) {
+                if (count_.exchange(0, std::memory_order_acq_rel) >= threshold) {
+                    domain_.reclaim_list(retired_);
+                }
+            }
+        }
+
+        reclaimer &domain_;
+        reclaimer::retired_list retired_{};
+        std::atomic<int> count_{0};
+    };
+
+
+    // Intrusive alternative to retire(T*, D): T derives from hazptr_obj_base<T, D> and the
+    // retire link lives in the object, so retiring neither allocates nor goes through a vtable.
+    template<typename T, typename D = std::default_delete<T>>
+    class hazptr_obj_base : private detail::retire_node {
+    public:
+        hazptr_obj_base() = default;
+
+        // the link belongs to this object, copies start unlinked
+        hazptr_obj_base(const hazptr_obj_base &) noexcept: detail::retire_node() {}
+
+        hazptr_obj_base &operator=(const hazptr_obj_base &) noexcept { return *this; }
+
+        void retire(D deleter = {}, reclaimer &domain = reclaimer::instance()) {
+            prepare(std::move(deleter));
+            domain.push_retired(this);
+        }
+
+        void retire(cohort &owner, D deleter = {}) {
+            prepare(std::move(deleter));
+            owner.push_retired(this);
+        }
+
+    private:
+        void prepare(D &&deleter) {
+            deleter_ = std::move(deleter);
+            raw_ = static_cast<const T *>(this);
+            bytes_ = sizeof(T);
+            reclaim_ = &reclaim_impl;
+        }
+
+        static void reclaim_impl(detail::retire_node *node) {
+            auto obj = static_cast<hazptr_obj_base *>(node);
+            // move the deleter out first, it is a member of the object it deletes
+            auto deleter = std::move(obj->deleter_);
+            deleter(static_cast<T *>(obj));
+        }
+
+        [[no_unique_address]] D deleter_{};
+    };
 
     template<uint8_t size>
     class hazard_local {
         hazptr_array<size> hazptrs_;
 
     public:
-        hazard_local() : hazptrs_(reclaimer::make_hazard_ptr<size>()) {
+        hazard_local() : hazptrs_(reclaimer::instance().make_hazard_ptr<size>()) {
         }
 
         ~hazard_local() {
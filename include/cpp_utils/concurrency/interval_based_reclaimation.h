@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "reclamation_detail.h"
+
+namespace alp_utils::ibr {
+    class reclaimer;
+
+    template<typename T, typename D>
+    class ibr_obj_base;
+
+    namespace detail {
+        struct retire_node {
+            void reclaim() { reclaim_(this); }
+
+            retire_node *next_{nullptr};
+            // an object is alive during [birth_era_, retire_era_]
+            uint64_t birth_era_{0};
+            uint64_t retire_era_{0};
+            void (*reclaim_)(retire_node *){nullptr};
+        };
+
+        struct retired_list {
+            bool empty() const noexcept { return head_ == nullptr; }
+
+            size_t size() const noexcept { return size_; }
+
+            void push(retire_node *node) noexcept {
+                node->next_ = head_;
+                head_ = node;
+                ++size_;
+            }
+
+            void splice(retired_list &other) noexcept {
+                while (!other.empty()) {
+                    auto node = other.head_;
+                    other.head_ = node->next_;
+                    push(node);
+                }
+                other.size_ = 0;
+            }
+
+            retire_node *head_{nullptr};
+            size_t size_{0};
+        };
+
+        // Per thread reservation, the thread may hold references to objects alive at any era
+        // in [lower_, upper_]. lower_ is INACTIVE outside a critical section.
+        struct alignas(std::hardware_destructive_interference_size) thread_record
+                : reclamation_detail::registry_entry<thread_record> {
+            static constexpr uint64_t INACTIVE = std::numeric_limits<uint64_t>::max();
+
+            std::atomic<uint64_t> lower_{INACTIVE};
+            std::atomic<uint64_t> upper_{0};
+
+            // below are only touched by the owner thread
+            uint32_t nesting_{0};
+            uint32_t retired_{0};
+            retired_list retired_list_{};
+        };
+
+        struct interval {
+            uint64_t lower;
+            uint64_t upper;
+        };
+    } // namespace detail
+
+    // Interval based reclamation (2GEIBR), a hybrid of hazard eras and epochs: objects are stamped
+    // with the era they were born and retired in, and a reader publishes the interval of eras it
+    // has observed instead of each pointer. An object is reclaimed once no published interval
+    // overlaps its lifetime, so a stalled reader only pins objects that were alive while it ran,
+    // and protect is two loads unless the era moved since the last one.
+    class reclaimer {
+        using record = detail::thread_record;
+
+    public:
+        // retires per thread between two era increments
+        static constexpr uint32_t kEraFrequency = 32;
+
+        // retires per thread between two scans of the reservations
+        static constexpr uint32_t kCollectInterval = 64;
+
+        reclaimer(const reclaimer &) = delete;
+
+        reclaimer &operator=(const reclaimer &) = delete;
+
+        reclaimer(reclaimer &&) = delete;
+
+        reclaimer &operator=(reclaimer &&) = delete;
+
+        ~reclaimer() {
+            orphans_.update(&reclaimer::reclaim_all);
+            for (auto rec = records_.head(); rec != nullptr; rec = rec->next_) {
+                reclaim_all(rec->retired_list_);
+            }
+        }
+
+        static reclaimer &instance() {
+            static reclaimer instance;
+            return instance;
+        }
+
+        uint64_t era() const {
+            return era_.load(std::memory_order_acquire);
+        }
+
+        void enter() {
+            enter(local());
+        }
+
+        void exit() {
+            exit(local());
+        }
+
+        bool in_critical_section() {
+            return local()->nesting_ != 0;
+        }
+
+        template<typename T>
+        T *protect(const std::atomic<T *> &src) {
+            return protect(local(), src);
+        }
+
+        // Non intrusive objects have no birth era, they are treated as born at era 0 and are
+        // held back by every reader that started before they were retired, like with EBR.
+        template<typename T, typename D = std::default_delete<T>>
+        void retire(T *ptr, D &&deleter = {}) {
+            push_retired(reclamation_detail::make_retire_node<detail::retire_node>(ptr, std::forward<D>(deleter)));
+        }
+
+        // reclaims every object retired by this thread or by exited threads that no reader holds
+        void reclaim() {
+            era_.fetch_add(1, std::memory_order_acq_rel);
+            auto rec = local();
+            scan(rec->retired_list_);
+            scan_orphans();
+        }
+
+        // objects retired by this thread and by exited threads, not yet reclaimed
+        size_t pending() {
+            auto orphans = orphans_.update([](const detail::retired_list &orphans) { return orphans.size(); });
+            return local()->retired_list_.size() + orphans;
+        }
+
+    private:
+        friend class guard;
+
+        template<typename T, typename D>
+        friend class ibr_obj_base;
+
+        reclaimer() = default;
+
+        friend class reclamation_detail::record_registry<reclaimer, record>;
+
+        record *local() {
+            return records_.local();
+        }
+
+        // critical sections nest, only the outermost one publishes the interval
+        void enter(record *rec) {
+            if (rec->nesting_++ == 0) {
+                auto era = era_.load(std::memory_order_acquire);
+                rec->upper_.store(era, std::memory_order_relaxed);
+                rec->lower_.store(era, std::memory_order_relaxed);
+                // the reservation must be visible before any protected load
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        void exit(record *rec) {
+            if (--rec->nesting_ == 0) {
+                rec->lower_.store(record::INACTIVE, std::memory_order_release);
+            }
+        }
+
+        // the pointer is only returned once the era read after it is covered by the reservation
+        template<typename T>
+        T *protect(record *rec, const std::atomic<T *> &src) {
+            auto upper = rec->upper_.load(std::memory_order_relaxed);
+            while (true) {
+                auto ptr = src.load(std::memory_order_acquire);
+                auto era = era_.load(std::memory_order_acquire);
+                if (era == upper) [[likely]] {
+                    return ptr;
+                }
+                rec->upper_.store(era, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                upper = era;
+            }
+        }
+
+        void push_retired(detail::retire_node *node) {
+            auto rec = local();
+            // pairs with the fences of enter and protect, the unlink of the object is ordered
+            // before the stamp, so a reader that still sees it has reserved an era it covers
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            node->retire_era_ = era_.load(std::memory_order_acquire);
+            rec->retired_list_.push(node);
+
+            auto retired = ++rec->retired_;
+            if (retired % kEraFrequency == 0) [[unlikely]] {
+                era_.fetch_add(1, std::memory_order_acq_rel);
+            }
+            if (retired >= kCollectInterval) [[unlikely]] {
+                rec->retired_ = 0;
+                scan(rec->retired_list_);
+                if (!orphans_.empty()) [[unlikely]] {
+                    scan_orphans();
+                }
+            }
+        }
+
+        // called when the thread that owns rec exits, its retired objects go to the orphans
+        void release(record *rec) {
+            orphans_.update([rec](detail::retired_list &orphans) { orphans.splice(rec->retired_list_); });
+            rec->nesting_ = 0;
+            rec->retired_ = 0;
+            rec->lower_.store(record::INACTIVE, std::memory_order_release);
+            records_.release(rec);
+        }
+
+        void load_intervals(std::vector<detail::interval> &intervals) const {
+            intervals.clear();
+            for (auto rec = records_.head(); rec != nullptr; rec = rec->next_) {
+                auto lower = rec->lower_.load(std::memory_order_acquire);
+                if (lower == record::INACTIVE) {
+                    continue;
+                }
+                // upper_ is read after lower_, so a reservation that moved on is still covered
+                intervals.push_back({lower, rec->upper_.load(std::memory_order_acquire)});
+            }
+        }
+
+        static bool conflicts(const std::vector<detail::interval> &intervals, const detail::retire_node *node) {
+            return std::any_of(intervals.begin(), intervals.end(), [node](const detail::interval &reserved) {
+                return reserved.lower <= node->retire_era_ && node->birth_era_ <= reserved.upper;
+            });
+        }
+
+        // unlinks the objects no reservation overlaps
+        detail::retired_list extract_ready(detail::retired_list &retired) {
+            if (retired.empty()) {
+                return {};
+            }
+            // pairs with the fences of enter and protect, retired objects are unlinked before it
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            static thread_local std::vector<detail::interval> intervals;
+            load_intervals(intervals);
+
+            detail::retired_list kept{};
+            detail::retired_list ready{};
+            auto node = retired.head_;
+            while (node != nullptr) {
+                auto next = node->next_;
+                if (conflicts(intervals, node)) {
+                    kept.push(node);
+                } else {
+                    ready.push(node);
+                }
+                node = next;
+            }
+            retired = kept;
+            return ready;
+        }
+
+        void scan(detail::retired_list &retired) {
+            auto ready = extract_ready(retired);
+            reclaim_all(ready);
+        }
+
+        void scan_orphans() {
+            auto ready = orphans_.update([this](detail::retired_list &orphans) { return extract_ready(orphans); });
+            // destructors may retire again, so reclaim outside the lock
+            reclaim_all(ready);
+        }
+
+        static void reclaim_all(detail::retired_list &list) {
+            auto node = list.head_;
+            list = {};
+            while (node != nullptr) {
+                auto next = node->next_;
+                node->reclaim();
+                node = next;
+            }
+        }
+
+        alignas(std::hardware_destructive_interference_size) std::atomic<uint64_t> era_{1};
+
+        reclamation_detail::record_registry<reclaimer, record> records_{};
+
+        reclamation_detail::orphan_list<detail::retired_list> orphans_{};
+    };
+
+    // RAII critical section, the counterpart of a hazp::hazard_ptr and an ebr::guard,
+    // pointers loaded through protect stay valid until reset or destruction
+    class guard {
+    public:
+        guard() : domain_(reclaimer::instance()), rec_(domain_.local()) { domain_.enter(rec_); }
+
+        guard(const guard &) = delete;
+
+        guard &operator=(const guard &) = delete;
+
+        ~guard() { reset(); }
+
+        template<typename T>
+        T *protect(const std::atomic<T *> &ptr) const {
+            return domain_.protect(rec_, ptr);
+        }
+
+        void reset() {
+            if (rec_ != nullptr) {
+                domain_.exit(std::exchange(rec_, nullptr));
+            }
+        }
+
+    private:
+        reclaimer &domain_;
+        detail::thread_record *rec_;
+    };
+
+    // Intrusive objects carry their birth era, so readers that started after such an object
+    // was created, or that ended before it was retired, never hold it back.
+    template<typename T, typename D = std::default_delete<T>>
+    class ibr_obj_base : private detail::retire_node {
+    public:
+        ibr_obj_base() { birth_era_ = reclaimer::instance().era(); }
+
+        // a copy is a new object with its own birth era
+        ibr_obj_base(const ibr_obj_base &) : ibr_obj_base() {}
+
+        ibr_obj_base &operator=(const ibr_obj_base &) noexcept { return *this; }
+
+        void retire(D deleter = {}) {
+            deleter_ = std::move(deleter);
+            reclaim_ = &reclaim_impl;
+            reclaimer::instance().push_retired(this);
+        }
+
+    private:
+        static void reclaim_impl(detail::retire_node *node) {
+            auto obj = static_cast<ibr_obj_base *>(node);
+            // move the deleter out first, it is a member of the object it deletes
+            auto deleter = std::move(obj->deleter_);
+            deleter(static_cast<T *>(obj));
+        }
+
+        [[no_unique_address]] D deleter_{};
+    };
+
+    static inline void enter() { reclaimer::instance().enter(); }
+
+    static inline void exit() { reclaimer::instance().exit(); }
+
+    template<typename T, typename D = std::default_delete<T>>
+    static inline void retire(T *ptr, D deleter = {}) {
+        reclaimer::instance().retire(ptr, std::move(deleter));
+    }
+
+    static inline void reclaim() {
+        reclaimer::instance().reclaim();
+    }
+} // namespace alp_utils::ibr
@@ -1,29 +1,93 @@
 #pragma once
 #include <atomic>
 #include <memory>
+#include <utility>
+
+#include "epoch_based_reclaimation.h"
 
 namespace alp_utils {
+	// Readers enter an epoch critical section and read a raw pointer, they only write their own
+	// epoch record, so the read side never touches a shared cache line. Writers publish a new
+	// version and retire the old one, it is freed once every reader that could see it has left.
 	template <typename T>
 	class rcu_ez {
 
 	public:
+		// Keeps the version it was loaded from alive without a reference count. load() returned a
+		// std::shared_ptr<T> before, read_ptr differs from it in what callers can do:
+		// - it gives const access only, store a new version instead of writing through it
+		// - it moves but does not copy, and it must be destroyed on the thread that loaded it,
+		//   since it holds that thread's epoch critical section
+		// - it pins reclamation for every writer while alive, so hold it briefly and copy the
+		//   value out if it has to outlive the read
+		class read_ptr {
+		public:
+			read_ptr(const read_ptr&)			 = delete;
+			read_ptr& operator=(const read_ptr&) = delete;
+
+			read_ptr(read_ptr&& other) noexcept
+				: ptr_(std::exchange(other.ptr_, nullptr)), active_(std::exchange(other.active_, false)) {}
+
+			read_ptr& operator=(read_ptr&& other) noexcept {
+				if (this != &other) {
+					reset();
+					ptr_	= std::exchange(other.ptr_, nullptr);
+					active_ = std::exchange(other.active_, false);
+				}
+				return *this;
+			}
+
+			~read_ptr() { reset(); }
+
+			// leaves the critical section early, the pointer is dropped with it
+			void reset() noexcept {
+				ptr_ = nullptr;
+				if (std::exchange(active_, false)) {
+					ebr::exit();
+				}
+			}
+
+			const T* get() const noexcept { return ptr_; }
+
+			const T& operator*() const noexcept { return *ptr_; }
+
+			const T* operator->() const noexcept { return ptr_; }
+
+			explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+		private:
+			friend class rcu_ez;
+
+			explicit read_ptr(const std::atomic<T*>& src) {
+				ebr::enter();
+				active_ = true;
+				ptr_	= src.load(std::memory_order_acquire);
+			}
+
+			const T* ptr_{nullptr};
+			bool	 active_{false};
+		};
+
 		rcu_ez() = default;
 
-		~rcu_ez() = default;
+		~rcu_ez() { delete data_.load(std::memory_order_relaxed); }
 
 		rcu_ez(const rcu_ez&)			 = delete;
 		rcu_ez& operator=(const rcu_ez&) = delete;
 
 
-		std::shared_ptr<T> load() { return data_.load(std::memory_order_relaxed); }
+		read_ptr load() const { return read_ptr(data_); }
 
 		template <typename... Args>
 		void store(Args&&... args) {
-			data_.store(std::make_shared<T>(args...), std::memory_order_relaxed);
+			auto old = data_.exchange(new T(std::forward<Args>(args)...), std::memory_order_acq_rel);
+			if (old != nullptr) {
+				ebr::retire(old);
+			}
 		}
 
 	private:
-		std::atomic<std::shared_ptr<T>> data_{};
+		std::atomic<T*> data_{nullptr};
 	};
 
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+
+#include "epoch_based_reclaimation.h"
+#include "hazard_ptr.h"
+
+namespace alp_utils {
+    // A reclamation policy lets a lock-free container pick its scheme through a template parameter.
+    // An operation keeps a guard alive while it dereferences shared nodes and loads them through
+    // guard.protect, a node unlinked from the structure is handed to Reclaim::retire. A guard only
+    // has to keep the pointer it loaded last valid, so containers protect one node at a time.
+    template<typename Reclaim>
+    concept reclamation_policy = std::default_initializable<typename Reclaim::guard> &&
+                                 requires(typename Reclaim::guard &guard, std::atomic<int *> &src, int *ptr) {
+                                     { guard.protect(src) } -> std::same_as<int *>;
+                                     guard.reset();
+                                     Reclaim::retire(ptr);
+                                 };
+
+    // hazard pointers: a guard owns one hazard pointer taken from the thread cache
+    struct hazp_reclamation {
+        class guard {
+        public:
+            guard() : hp_(hazp::make_hazard_ptr()) {}
+
+            template<typename T>
+            T *protect(std::atomic<T *> &src) { return hp_.protect(src); }
+
+            void reset() { hp_.reset(); }
+
+        private:
+            hazp::hazard_ptr hp_;
+        };
+
+        template<typename T>
+        static void retire(T *ptr) { hazp::retire(ptr); }
+    };
+
+    // epochs: a guard is a critical section, protect is a plain acquire load
+    struct ebr_reclamation {
+        using guard = ebr::guard;
+
+        template<typename T>
+        static void retire(T *ptr) { ebr::retire(ptr); }
+    };
+
+    static_assert(reclamation_policy<hazp_reclamation>);
+    static_assert(reclamation_policy<ebr_reclamation>);
+} // namespace alp_utils
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Building blocks shared by the reclamation schemes, not meant to be used directly.
+namespace alp_utils::reclamation_detail {
+    // Allocates a Node owning ptr and its deleter, Node is the retire link of a scheme and needs
+    // a reclaim_ member that the scheme calls with the node once the object can be deleted.
+    template<typename Node, typename T, typename D>
+    Node *make_retire_node(T *ptr, D &&deleter) {
+        // keep a copy of the deleter, an lvalue D must not leave a dangling reference
+        using deleter_type = std::decay_t<D>;
+
+        struct retire_node_impl : public Node {
+            explicit retire_node_impl(std::unique_ptr<T, deleter_type> ptr) : ptr_(std::move(ptr)) {}
+
+            std::unique_ptr<T, deleter_type> ptr_;
+        };
+
+        // owned before the allocation, so a throwing new still deletes ptr
+        auto unique_ptr = std::unique_ptr<T, deleter_type>(ptr, std::forward<D>(deleter));
+
+        auto node = new retire_node_impl(std::move(unique_ptr));
+        node->reclaim_ = [](Node *obj) { delete static_cast<retire_node_impl *>(obj); };
+        return node;
+    }
+
+    // base of a per thread record kept in a record_registry
+    template<typename Record>
+    struct registry_entry {
+        // cleared when the owner thread exits, so another thread can take the record
+        std::atomic<bool> in_use_{true};
+        // written once before the record is published
+        Record *next_{nullptr};
+    };
+
+    // Lock free list of per thread records. Records are never unlinked, a record left by an
+    // exited thread is reused, so a scan may walk it at any time. When a thread exits, its
+    // record goes back through Owner::instance().release(rec), which hands whatever the thread
+    // still holds to the orphans and then calls release on the registry.
+    template<typename Owner, typename Record>
+    class record_registry {
+    public:
+        record_registry() = default;
+
+        record_registry(const record_registry &) = delete;
+
+        record_registry &operator=(const record_registry &) = delete;
+
+        // the owner empties the records before
+        ~record_registry() {
+            auto rec = head();
+            while (rec != nullptr) {
+                delete std::exchange(rec, rec->next_);
+            }
+        }
+
+        Record *head() const {
+            return head_.load(std::memory_order_acquire);
+        }
+
+        // the record of the calling thread
+        Record *local() {
+            static thread_local thread_handle handle;
+            if (handle.rec_ == nullptr) [[unlikely]] {
+                handle.rec_ = acquire();
+            }
+            return handle.rec_;
+        }
+
+        void release(Record *rec) {
+            rec->in_use_.store(false, std::memory_order_release);
+        }
+
+    private:
+        struct thread_handle {
+            Record *rec_{nullptr};
+
+            ~thread_handle() {
+                if (rec_ != nullptr) {
+                    Owner::instance().release(rec_);
+                }
+            }
+        };
+
+        Record *acquire() {
+            for (auto rec = head(); rec != nullptr; rec = rec->next_) {
+                bool expected = false;
+                if (!rec->in_use_.load(std::memory_order_relaxed) &&
+                    rec->in_use_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    return rec;
+                }
+            }
+
+            auto rec = new Record();
+            auto head = head_.load(std::memory_order_acquire);
+            do {
+                rec->next_ = head;
+            } while (!head_.compare_exchange_weak(head, rec, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire));
+            return rec;
+        }
+
+        alignas(std::hardware_destructive_interference_size) std::atomic<Record *> head_{nullptr};
+    };
+
+    // Retired objects left by exited threads, adopted by whichever thread collects next. size()
+    // is cached in an atomic, so the retire path can skip the lock while there are none.
+    template<typename Container>
+    class orphan_list {
+    public:
+        bool empty() const {
+            return count_.load(std::memory_order_acquire) == 0;
+        }
+
+        // Runs fn(container) under the lock and returns its result. Destructors may retire again,
+        // so the objects fn takes out must be reclaimed after this returns.
+        template<typename F>
+        decltype(auto) update(F &&fn) {
+            std::lock_guard lock(mutex_);
+            struct count_updater {
+                orphan_list &self;
+
+                ~count_updater() { self.count_.store(self.orphans_.size(), std::memory_order_release); }
+            } updater{*this};
+            return std::forward<F>(fn)(orphans_);
+        }
+
+    private:
+        std::mutex mutex_{};
+        Container orphans_{};
+        std::atomic<size_t> count_{0};
+    };
+} // namespace alp_utils::reclamation_detail
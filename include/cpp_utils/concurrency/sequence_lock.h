@@ -1,53 +1,56 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <mutex>
 #include <new>
+#include <optional>
+#include <type_traits>
+
+#include "spin_mutex.h"
 
 namespace alp_utils {
     namespace details {
-        template<typename Lock_Type>
-        struct atomic_lock {
-            static constexpr Lock_Type LOCKED = 1;
-            static constexpr Lock_Type UNLOCK = 0;
-
-            bool try_lock() {
-                Lock_Type expected = 0;
-                return lock_.compare_exchange_strong(expected, LOCKED,
-                                                     std::memory_order_acquire,
-                                                     std::memory_order_relaxed);
-            }
+        // a trivially copyable value split into words that are copied with relaxed atomics,
+        // torn copies are detected by the sequence around them
+        template<typename T>
+        struct inline_words {
+            static constexpr std::size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
 
-            void lock_impl() {
-                for (;;) {
-                    auto lk = lock_.load(std::memory_order_relaxed);
-                    if (lk & LOCKED) {
-                        lock_.wait(lk);
-                    } else {
-                        if (lock_.fetch_or(LOCKED, std::memory_order_relaxed) & LOCKED) {
-                            continue;
-                        }
-                        std::atomic_thread_fence(std::memory_order_acquire);
-                        return;
-                    }
+            void read(T &data) const {
+                std::array<uint64_t, kWords> words;
+                for (std::size_t i = 0; i < kWords; ++i) {
+                    words[i] = words_[i].load(std::memory_order_relaxed);
                 }
+                std::memcpy(&data, words.data(), sizeof(T));
             }
 
-            void lock() {
-                if (!try_lock()) {
-                    lock_impl();
+            void write(const T &data) {
+                std::array<uint64_t, kWords> words{};
+                std::memcpy(words.data(), &data, sizeof(T));
+                for (std::size_t i = 0; i < kWords; ++i) {
+                    words_[i].store(words[i], std::memory_order_relaxed);
                 }
             }
 
-            void unlock() {
-                lock_.store(UNLOCK, std::memory_order_release);
-                lock_.notify_one();
-            }
-
-            std::atomic<Lock_Type> lock_{0};
+            std::array<std::atomic<uint64_t>, kWords> words_{};
         };
+
+        // seq is the sequence loaded with acquire before the copy
+        template<typename T>
+        bool try_read(const std::atomic<uint32_t> &seq_word, uint32_t seq, const inline_words<T> &words, T &data) {
+            if ((seq & 1U) != 0U) {
+                return false;
+            }
+            words.read(data);
+            // keeps the word loads before the second sequence load
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return seq_word.load(std::memory_order_relaxed) == seq;
+        }
     }
 
     template<typename T>
@@ -77,7 +80,10 @@ namespace alp_utils {
             data = value_.load(std::memory_order_relaxed);
             uint32_t seq2 = seq_.load(std::memory_order_relaxed);
             while (((seq1 & 1U) != 0U) || seq1 != seq2) {
-                value_.wait(data, std::memory_order_relaxed);
+                // the value may never change again, so block on the sequence instead
+                if ((seq1 & 1U) != 0U) {
+                    seq_.wait(seq1, std::memory_order_relaxed);
+                }
                 seq1 = seq_.load(std::memory_order_relaxed);
                 data = value_.load(std::memory_order_relaxed);
                 seq2 = seq_.load(std::memory_order_relaxed);
@@ -136,6 +142,7 @@ namespace alp_utils {
             value_.store(std::make_shared<T>(*value_.load(std::memory_order_relaxed)), std::memory_order_relaxed);
             seq_.fetch_add(1, std::memory_order_release);
             lock_.unlock();
+            seq_.notify_all();
             value_.notify_all();
         }
 
@@ -144,10 +151,199 @@ namespace alp_utils {
         alignas(align) std::atomic<std::shared_ptr<T>> value_{};
 
         std::atomic<uint32_t> seq_{0};
-        details::atomic_lock<uint32_t> lock_{};
+        spin_mutex lock_{};
 
         static_assert(align > sizeof(seq_) + sizeof(lock_),
                       "seq_lock alignment is not enough");
         [[maybe_unused]] char padding[align - sizeof(seq_) - sizeof(lock_)]{};
     };
+
+    // Seqlock for trivially copyable values, stored inline and copied word by word with relaxed
+    // atomics, the sequence tells a reader whether its copy is torn. Neither side allocates or
+    // touches a reference count. Unlike seq_lock, load returns the value itself, store and update
+    // take the writer lock and bump the sequence on their own.
+    template<typename T> requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+    class inline_seq_lock {
+    public:
+        inline_seq_lock() : inline_seq_lock(T{}) {
+        }
+
+        template<typename ...Args>
+        explicit inline_seq_lock(Args &&... args) {
+            value_.write(T(std::forward<Args>(args)...));
+        }
+
+        ~inline_seq_lock() = default;
+
+        inline_seq_lock(const inline_seq_lock &) = delete;
+
+        inline_seq_lock &operator=(const inline_seq_lock &) = delete;
+
+        inline_seq_lock(inline_seq_lock &&) noexcept = delete;
+
+        inline_seq_lock &operator=(inline_seq_lock &&) noexcept = delete;
+
+        T load() const {
+            T data;
+            uint32_t seq = seq_.load(std::memory_order_acquire);
+            while (!try_read(seq, data)) {
+                // the value may never change again, so block on the sequence instead
+                if ((seq & 1U) != 0U) {
+                    seq_.wait(seq, std::memory_order_relaxed);
+                }
+                seq = seq_.load(std::memory_order_acquire);
+            }
+            return data;
+        }
+
+        std::optional<T> load(int retry) const {
+            T data;
+            for (int i = 0; i < retry; ++i) {
+                if (try_read(seq_.load(std::memory_order_acquire), data)) {
+                    return data;
+                }
+            }
+            return std::nullopt;
+        }
+
+        template<typename ...Args>
+        void store(Args &&... args) {
+            T data(std::forward<Args>(args)...);
+            {
+                std::lock_guard lock(lock_);
+                publish(data);
+            }
+            seq_.notify_all();
+        }
+
+        template<typename Fun>
+        void update(Fun &&fun) {
+            {
+                std::lock_guard lock(lock_);
+                T data;
+                value_.read(data);
+                fun(data);
+                publish(data);
+            }
+            seq_.notify_all();
+        }
+
+    private:
+        void publish(const T &data) {
+            seq_.fetch_add(1, std::memory_order_relaxed);
+            // the odd sequence must be visible before any word is overwritten
+            std::atomic_thread_fence(std::memory_order_release);
+            value_.write(data);
+            seq_.fetch_add(1, std::memory_order_release);
+        }
+
+        bool try_read(uint32_t seq, T &data) const {
+            return details::try_read(seq_, seq, value_, data);
+        }
+
+        static constexpr std::size_t align = std::hardware_destructive_interference_size;
+        // small payloads share the cache line of the sequence, a read touches a single line
+        alignas(align) std::atomic<uint32_t> seq_{0};
+        spin_mutex lock_{};
+        details::inline_words<T> value_{};
+    };
+
+    // Multi version seqlock: every store goes to the oldest of N slots, each with its own sequence,
+    // and then publishes it as the newest. A reader copies the newest slot, which is only rewritten
+    // after N - 1 more stores, so it rarely retries even when the writer is much faster than it,
+    // and falls back to older slots instead of waiting. Writers are serialized, never by readers.
+    template<typename T, std::size_t N = 4>
+        requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && (N >= 2)
+    class seq_ring {
+    public:
+        seq_ring() : seq_ring(T{}) {
+        }
+
+        template<typename ...Args>
+        explicit seq_ring(Args &&... args) {
+            slots_[0].value_.write(T(std::forward<Args>(args)...));
+        }
+
+        ~seq_ring() = default;
+
+        seq_ring(const seq_ring &) = delete;
+
+        seq_ring &operator=(const seq_ring &) = delete;
+
+        seq_ring(seq_ring &&) noexcept = delete;
+
+        seq_ring &operator=(seq_ring &&) noexcept = delete;
+
+        T load() const {
+            T data;
+            while (!try_load(data)) {
+                // a failed copy means a writer is active, back off instead of hammering its lines
+                details::cpu_relax();
+            }
+            return data;
+        }
+
+        std::optional<T> load(int retry) const {
+            T data;
+            for (int i = 0; i < retry; ++i) {
+                if (try_load(data)) {
+                    return data;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // stores since construction
+        uint64_t version() const {
+            return version_.load(std::memory_order_acquire);
+        }
+
+        template<typename ...Args>
+        void store(Args &&... args) {
+            std::lock_guard lock(lock_);
+            publish(T(std::forward<Args>(args)...));
+        }
+
+        template<typename Fun>
+        void update(Fun &&fun) {
+            std::lock_guard lock(lock_);
+            T data;
+            slots_[version_.load(std::memory_order_relaxed) % N].value_.read(data);
+            fun(data);
+            publish(data);
+        }
+
+    private:
+        struct alignas(std::hardware_destructive_interference_size) slot {
+            std::atomic<uint32_t> seq_{0};
+            details::inline_words<T> value_{};
+        };
+
+        void publish(const T &data) {
+            auto version = version_.load(std::memory_order_relaxed) + 1;
+            auto &slot = slots_[version % N];
+            slot.seq_.fetch_add(1, std::memory_order_relaxed);
+            // the odd sequence must be visible before any word is overwritten
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.value_.write(data);
+            slot.seq_.fetch_add(1, std::memory_order_release);
+            version_.store(version, std::memory_order_release);
+        }
+
+        // newest slot first, an older one if the writer lapped the ring while we copied
+        bool try_load(T &data) const {
+            auto version = version_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < N - 1 && i <= version; ++i) {
+                auto &slot = slots_[(version - i) % N];
+                if (details::try_read(slot.seq_, slot.seq_.load(std::memory_order_acquire), slot.value_, data)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::array<slot, N> slots_{};
+        alignas(std::hardware_destructive_interference_size) std::atomic<uint64_t> version_{0};
+        spin_mutex lock_{};
+    };
 } // namespace alp_utils
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace alp_utils {
+    namespace details {
+        inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield" ::: "memory");
+#endif
+        }
+    }
+
+    // Adaptive mutex: spins a bounded number of times, then parks on the lock word, which the
+    // standard library implements with a futex on linux. The word remembers whether anyone may be
+    // parked, so an uncontended unlock is a single exchange and never a wake up syscall.
+    // unlock cannot be a plain store: it has to learn whether a waiter marked the word contended,
+    // and a load followed by a store would miss a waiter that marks it in between, which then
+    // sleeps with nobody left to wake it. The exchange reads and clears the word in one step.
+    class spin_mutex {
+    public:
+        static constexpr uint32_t UNLOCKED = 0;
+        static constexpr uint32_t LOCKED = 1;
+        // locked and someone may be parked
+        static constexpr uint32_t CONTENDED = 2;
+
+        // pauses before parking, roughly the cost of a futex round trip
+        static constexpr int kSpins = 128;
+
+        spin_mutex() = default;
+
+        spin_mutex(const spin_mutex &) = delete;
+
+        spin_mutex &operator=(const spin_mutex &) = delete;
+
+        bool try_lock() noexcept {
+            uint32_t expected = UNLOCKED;
+            return state_.compare_exchange_strong(expected, LOCKED,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_relaxed);
+        }
+
+        void lock() noexcept {
+            if (!try_lock()) [[unlikely]] {
+                lock_slow();
+            }
+        }
+
+        void unlock() noexcept {
+            if (state_.exchange(UNLOCKED, std::memory_order_release) == CONTENDED) [[unlikely]] {
+                state_.notify_one();
+            }
+        }
+
+    private:
+        void lock_slow() noexcept {
+            for (int i = 0; i < kSpins; ++i) {
+                // only write the line once it looks free
+                if (state_.load(std::memory_order_relaxed) == UNLOCKED && try_lock()) {
+                    return;
+                }
+                details::cpu_relax();
+            }
+            // a lock taken from here is marked contended, so its unlock wakes the next waiter
+            while (state_.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+                state_.wait(CONTENDED, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<uint32_t> state_{UNLOCKED};
+    };
+} // namespace alp_utils
@@ -2,6 +2,7 @@
 
 #include <map>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <queue>
@@ -1616,6 +1617,12 @@ namespace alp_utils {
 
         avl_map() = default;
 
+        explicit avl_map(const Compare_ &comp, const allocator_type &a = allocator_type())
+                : t_(comp, pair_alloc_type(a)) {}
+
+        // for stateful allocators that cannot be default constructed
+        explicit avl_map(const allocator_type &a) : t_(Compare_(), pair_alloc_type(a)) {}
+
         ~avl_map() = default;
 
         iterator begin() noexcept { return t_.begin(); }
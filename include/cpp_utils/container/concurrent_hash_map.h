@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+#include "../concurrency/hazard_ptr.h"
+#include "../concurrency/spin_mutex.h"
+
+namespace alp_utils {
+
+    // Chained hash map with a lock per bucket for writers and lock-free readers. Readers walk a
+    // bucket under hazard pointers, a node is only retired after the link leaving it has been
+    // marked, so a reader that advances from an unmarked link only protects linked nodes.
+    // Entries are immutable once inserted, insert_or_assign swaps in a new node.
+    // Growing is incremental: a resize links a table of twice the buckets to the current one and
+    // every writer moves a chunk of buckets before its own update. A moved bucket is marked as
+    // forwarded and readers follow it to the new table, the old table and the nodes copied out
+    // of it are retired through hazp once the last bucket has moved. Values are copied on a
+    // resize, so they have to be copy constructible.
+    template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class concurrent_hash_map {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using size_type = size_t;
+
+        // average chain length that starts a resize
+        static constexpr size_t kMaxLoadFactor = 2;
+        // buckets a writer moves per update while a resize is running
+        static constexpr size_t kMigrateChunk = 16;
+
+    private:
+        struct node : hazp::hazptr_obj_base<node> {
+            template<typename ...Args>
+            explicit node(size_t hash, Args &&... args) : value_(std::forward<Args>(args)...), hash_(hash) {}
+
+            const key_type &key() const noexcept { return value_.first; }
+
+            value_type value_;
+            size_t hash_;
+            std::atomic<node *> next_{nullptr};
+        };
+
+        // a marked head means the bucket moved to the next table
+        struct bucket {
+            spin_mutex lock_;
+            std::atomic<node *> head_{nullptr};
+        };
+
+        struct table : hazp::hazptr_obj_base<table> {
+            explicit table(size_t count) : mask_(count - 1), buckets_(new bucket[count]) {}
+
+            size_t bucket_count() const noexcept { return mask_ + 1; }
+
+            bucket &bucket_for(size_t hash) const noexcept { return buckets_[hash & mask_]; }
+
+            const size_t mask_;
+            std::unique_ptr<bucket[]> buckets_;
+            // set once when a resize starts
+            std::atomic<table *> next_{nullptr};
+            alignas(std::hardware_destructive_interference_size) std::atomic<size_t> claimed_{0};
+            std::atomic<size_t> migrated_{0};
+        };
+
+        static bool is_marked(node *ptr) noexcept {
+            return (reinterpret_cast<uintptr_t>(ptr) & 1U) != 0;
+        }
+
+        static node *marked(node *ptr) noexcept {
+            return reinterpret_cast<node *>(reinterpret_cast<uintptr_t>(ptr) | 1U);
+        }
+
+        static node *unmarked(node *ptr) noexcept {
+            return reinterpret_cast<node *>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t{1});
+        }
+
+        struct local_hazards_t {
+            local_hazards_t() : table_(hazp::make_hazard_ptr()), pred_(hazp::make_hazard_ptr()),
+                                curr_(hazp::make_hazard_ptr()) {}
+
+            void reset() {
+                table_.reset();
+                pred_.reset();
+                curr_.reset();
+            }
+
+            hazp::hazard_ptr table_;
+            hazp::hazard_ptr pred_;
+            hazp::hazard_ptr curr_;
+        };
+
+        // operations do not nest, so a thread reuses the same slots for every map of this type
+        static local_hazards_t &local_hazards() {
+            static thread_local local_hazards_t hazards;
+            return hazards;
+        }
+
+    public:
+        // keeps the entry it was found at alive, even if it is erased or replaced meanwhile
+        class read_ptr {
+        public:
+            read_ptr() = default;
+
+            read_ptr(read_ptr &&) noexcept = default;
+
+            read_ptr &operator=(read_ptr &&) noexcept = default;
+
+            const value_type *get() const noexcept { return node_ ? &node_->value_ : nullptr; }
+
+            const value_type &operator*() const noexcept { return node_->value_; }
+
+            const value_type *operator->() const noexcept { return &node_->value_; }
+
+            explicit operator bool() const noexcept { return node_ != nullptr; }
+
+        private:
+            friend class concurrent_hash_map;
+
+            // n must be protected by the caller until this returns
+            explicit read_ptr(node *n) : hp_(hazp::make_hazard_ptr()), node_(n) {
+                hp_.reset_protection(n);
+            }
+
+            hazp::hazard_ptr hp_{};
+            node *node_{nullptr};
+        };
+
+        explicit concurrent_hash_map(size_t bucket_count = 16, const Hash &hash = Hash(),
+                                     const KeyEqual &equal = KeyEqual())
+                : table_(new table(std::bit_ceil(std::max<size_t>(bucket_count, 2)))), hash_(hash), equal_(equal) {}
+
+        // no other thread may use the map anymore
+        ~concurrent_hash_map() {
+            auto t = table_.load(std::memory_order_relaxed);
+            auto next = t->next_.load(std::memory_order_relaxed);
+            free_table(t);
+            if (next != nullptr) {
+                free_table(next);
+            }
+        }
+
+        concurrent_hash_map(const concurrent_hash_map &) = delete;
+
+        concurrent_hash_map &operator=(const concurrent_hash_map &) = delete;
+
+        size_type size() const noexcept {
+            auto size = size_.load(std::memory_order_relaxed);
+            return size < 0 ? 0 : static_cast<size_type>(size);
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        // buckets of the newest table, including one that is still being filled by a resize
+        size_type bucket_count() const {
+            auto &hazards = local_hazards();
+            while (true) {
+                // the next table is safe while table_ has not moved past t
+                auto t = hazards.table_.protect(table_);
+                auto next = hazards.pred_.protect(t->next_);
+                if (table_.load(std::memory_order_acquire) == t) {
+                    auto count = next != nullptr ? next->bucket_count() : t->bucket_count();
+                    hazards.reset();
+                    return count;
+                }
+            }
+        }
+
+        bool contains(const key_type &key) const {
+            auto &hazards = local_hazards();
+            auto found = search(key, hash_(key), hazards) != nullptr;
+            hazards.reset();
+            return found;
+        }
+
+        read_ptr find(const key_type &key) const {
+            auto &hazards = local_hazards();
+            auto n = search(key, hash_(key), hazards);
+            auto ptr = n != nullptr ? read_ptr(n) : read_ptr();
+            hazards.reset();
+            return ptr;
+        }
+
+        // copies the value out, cheaper than find for small values
+        std::optional<mapped_type> get(const key_type &key) const {
+            auto &hazards = local_hazards();
+            std::optional<mapped_type> value;
+            if (auto n = search(key, hash_(key), hazards); n != nullptr) {
+                value.emplace(n->value_.second);
+            }
+            hazards.reset();
+            return value;
+        }
+
+        bool insert(const value_type &value) {
+            return emplace(value.first, value.second);
+        }
+
+        // returns false and constructs nothing if the key is present
+        template<typename ...Args>
+        bool emplace(const key_type &key, Args &&... args) {
+            auto hash = hash_(key);
+            auto &hazards = local_hazards();
+            auto &b = lock_bucket(hash, hazards);
+            if (locate(b, key, hash) != nullptr) {
+                b.lock_.unlock();
+                hazards.reset();
+                return false;
+            }
+            auto n = new node(hash, std::piecewise_construct, std::forward_as_tuple(key),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+            n->next_.store(b.head_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            b.head_.store(n, std::memory_order_release);
+            b.lock_.unlock();
+            grow_if_needed(size_.fetch_add(1, std::memory_order_relaxed) + 1, hazards);
+            hazards.reset();
+            return true;
+        }
+
+        // returns true if the key was inserted, false if its value was replaced
+        template<typename V>
+        bool insert_or_assign(const key_type &key, V &&value) {
+            auto hash = hash_(key);
+            auto n = new node(hash, key, std::forward<V>(value));
+            auto &hazards = local_hazards();
+            auto &b = lock_bucket(hash, hazards);
+            if (auto link = locate(b, key, hash); link != nullptr) {
+                auto old = link->load(std::memory_order_relaxed);
+                auto next = old->next_.load(std::memory_order_relaxed);
+                n->next_.store(next, std::memory_order_relaxed);
+                old->next_.store(marked(next), std::memory_order_release);
+                link->store(n, std::memory_order_release);
+                b.lock_.unlock();
+                old->retire();
+                hazards.reset();
+                return false;
+            }
+            n->next_.store(b.head_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            b.head_.store(n, std::memory_order_release);
+            b.lock_.unlock();
+            grow_if_needed(size_.fetch_add(1, std::memory_order_relaxed) + 1, hazards);
+            hazards.reset();
+            return true;
+        }
+
+        bool erase(const key_type &key) {
+            auto hash = hash_(key);
+            auto &hazards = local_hazards();
+            auto &b = lock_bucket(hash, hazards);
+            auto link = locate(b, key, hash);
+            if (link == nullptr) {
+                b.lock_.unlock();
+                hazards.reset();
+                return false;
+            }
+            auto old = link->load(std::memory_order_relaxed);
+            auto next = old->next_.load(std::memory_order_relaxed);
+            old->next_.store(marked(next), std::memory_order_release);
+            link->store(next, std::memory_order_release);
+            b.lock_.unlock();
+            old->retire();
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            hazards.reset();
+            return true;
+        }
+
+    private:
+        // Returns the node of key protected by hazards.curr_, or nullptr. A marked link means
+        // the node it leaves was unlinked, the walk restarts at the head of the bucket.
+        node *search(const key_type &key, size_t hash, local_hazards_t &hazards) const {
+            auto t = hazards.table_.protect(table_);
+            while (true) {
+                auto &b = t->bucket_for(hash);
+                auto curr = hazards.curr_.protect(b.head_, &unmarked);
+                if (is_marked(curr)) {
+                    t = next_table(t, hazards);
+                    continue;
+                }
+                while (curr != nullptr) {
+                    if (curr->hash_ == hash && equal_(curr->key(), key)) {
+                        return curr;
+                    }
+                    auto next = hazards.pred_.protect(curr->next_, &unmarked);
+                    if (is_marked(next)) {
+                        break;
+                    }
+                    swap(hazards.pred_, hazards.curr_);
+                    curr = next;
+                }
+                if (curr == nullptr) {
+                    return nullptr;
+                }
+            }
+        }
+
+        // Moves the table protection to the table t forwards to. That table may only be
+        // retired after table_ moved past it, so it is safe while table_ is still t or it.
+        table *next_table(table *t, local_hazards_t &hazards) const {
+            auto next = hazards.pred_.protect(t->next_);
+            auto current = table_.load(std::memory_order_acquire);
+            if (current == t || current == next) {
+                swap(hazards.table_, hazards.pred_);
+                hazards.pred_.reset();
+                return next;
+            }
+            return hazards.table_.protect(table_);
+        }
+
+        // returns the locked bucket for hash that has not moved, hazards.table_ protects its table
+        bucket &lock_bucket(size_t hash, local_hazards_t &hazards) {
+            auto t = hazards.table_.protect(table_);
+            help_migrate(t, hazards);
+            while (true) {
+                auto &b = t->bucket_for(hash);
+                b.lock_.lock();
+                if (!is_marked(b.head_.load(std::memory_order_relaxed))) {
+                    return b;
+                }
+                b.lock_.unlock();
+                t = next_table(t, hazards);
+            }
+        }
+
+        // the link pointing at the node of key, nullptr if absent, the bucket must be locked
+        std::atomic<node *> *locate(bucket &b, const key_type &key, size_t hash) const {
+            auto link = &b.head_;
+            for (auto curr = link->load(std::memory_order_relaxed); curr != nullptr;
+                 curr = link->load(std::memory_order_relaxed)) {
+                if (curr->hash_ == hash && equal_(curr->key(), key)) {
+                    return link;
+                }
+                link = &curr->next_;
+            }
+            return nullptr;
+        }
+
+        void grow_if_needed(int64_t size, local_hazards_t &hazards) {
+            auto t = hazards.table_.protect(table_);
+            if (static_cast<size_t>(size) <= t->bucket_count() * kMaxLoadFactor ||
+                t->next_.load(std::memory_order_relaxed) != nullptr) {
+                return;
+            }
+            auto next = new table(t->bucket_count() * 2);
+            table *expected = nullptr;
+            if (!t->next_.compare_exchange_strong(expected, next, std::memory_order_acq_rel)) {
+                delete next;
+            }
+        }
+
+        // moves a chunk of buckets of t if a resize of t is running
+        void help_migrate(table *t, local_hazards_t &hazards) {
+            if (t->next_.load(std::memory_order_acquire) == nullptr) [[likely]] {
+                return;
+            }
+            auto next = hazards.pred_.protect(t->next_);
+            if (table_.load(std::memory_order_acquire) != t) {
+                hazards.pred_.reset();
+                return;
+            }
+            auto count = t->bucket_count();
+            auto begin = t->claimed_.fetch_add(kMigrateChunk, std::memory_order_relaxed);
+            if (begin < count) {
+                auto end = std::min(begin + kMigrateChunk, count);
+                for (auto i = begin; i < end; ++i) {
+                    migrate_bucket(t->buckets_[i], *next);
+                }
+                // the last mover publishes the new table, readers still on t hold it protected
+                if (t->migrated_.fetch_add(end - begin, std::memory_order_acq_rel) + (end - begin) == count) {
+                    table_.store(next, std::memory_order_release);
+                    t->retire();
+                }
+            }
+            hazards.pred_.reset();
+        }
+
+        // Copies the chain into the new table and forwards the bucket. The destination buckets
+        // are only reachable through this one until it is forwarded, so they need no lock.
+        // The old links are marked first so a reader still in the chain restarts instead of
+        // protecting a node that was already retired.
+        void migrate_bucket(bucket &b, table &next) {
+            std::lock_guard<spin_mutex> lock(b.lock_);
+            auto head = b.head_.load(std::memory_order_relaxed);
+            for (auto curr = head; curr != nullptr; curr = curr->next_.load(std::memory_order_relaxed)) {
+                auto &dest = next.bucket_for(curr->hash_);
+                auto copy = new node(curr->hash_, curr->value_);
+                copy->next_.store(dest.head_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                dest.head_.store(copy, std::memory_order_release);
+            }
+            for (auto curr = head; curr != nullptr;) {
+                auto next_node = curr->next_.load(std::memory_order_relaxed);
+                curr->next_.store(marked(next_node), std::memory_order_release);
+                curr = next_node;
+            }
+            b.head_.store(marked(nullptr), std::memory_order_release);
+            while (head != nullptr) {
+                auto next_node = unmarked(head->next_.load(std::memory_order_relaxed));
+                head->retire();
+                head = next_node;
+            }
+        }
+
+        static void free_table(table *t) {
+            for (size_t i = 0; i < t->bucket_count(); ++i) {
+                auto curr = t->buckets_[i].head_.load(std::memory_order_relaxed);
+                while (!is_marked(curr) && curr != nullptr) {
+                    auto next = curr->next_.load(std::memory_order_relaxed);
+                    delete curr;
+                    curr = next;
+                }
+            }
+            delete t;
+        }
+
+        mutable std::atomic<table *> table_;
+        alignas(std::hardware_destructive_interference_size) std::atomic<int64_t> size_{0};
+        [[no_unique_address]] Hash hash_;
+        [[no_unique_address]] KeyEqual equal_;
+    };
+
+} // namespace alp_utils
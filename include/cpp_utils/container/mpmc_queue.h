@@ -0,0 +1,451 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../concurrency/reclamation.h"
+
+namespace alp_utils {
+    namespace detail {
+        // a slot that is constructed and destroyed by hand, the queues track whether it is live
+        template<typename T>
+        struct queue_storage {
+            template<typename ...Args>
+            void construct(Args &&... args) { new(data_) T(std::forward<Args>(args)...); }
+
+            T &get() noexcept { return *std::launder(reinterpret_cast<T *>(data_)); }
+
+            // moves the value out and destroys the slot
+            T take() {
+                T value(std::move(get()));
+                get().~T();
+                return value;
+            }
+
+            alignas(T) unsigned char data_[sizeof(T)];
+        };
+    } // namespace detail
+
+    // Bounded MPMC queue (Vyukov): every cell carries a sequence telling which lap of the ring
+    // may use it next, so producers and consumers only contend on their own position counter.
+    // Bulk operations claim a run of ready cells with a single CAS of the position. A claimed cell
+    // cannot be given back, so nothing that may throw runs while a thread holds one: a value that
+    // cannot be built from the arguments without throwing is built before the cell is claimed and
+    // moved in, and a popped value is moved out and the cell released before it is assigned.
+    template<typename T>
+    class bounded_queue {
+        static_assert(std::is_nothrow_move_constructible_v<T>,
+                      "bounded_queue values must be movable without throwing");
+
+        struct cell {
+            std::atomic<size_t> seq_;
+            detail::queue_storage<T> storage_;
+        };
+
+    public:
+        // capacity is rounded up to a power of two
+        explicit bounded_queue(size_t capacity) : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+                                                  cells_(new cell[mask_ + 1]) {
+            for (size_t i = 0; i <= mask_; ++i) {
+                cells_[i].seq_.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // no other thread may use the queue anymore
+        ~bounded_queue() {
+            auto tail = enqueue_pos_.load(std::memory_order_relaxed);
+            for (auto pos = dequeue_pos_.load(std::memory_order_relaxed); pos != tail; ++pos) {
+                cells_[pos & mask_].storage_.get().~T();
+            }
+        }
+
+        bounded_queue(const bounded_queue &) = delete;
+
+        bounded_queue &operator=(const bounded_queue &) = delete;
+
+        size_t capacity() const noexcept { return mask_ + 1; }
+
+        // approximate while other threads push or pop
+        size_t size() const noexcept {
+            auto head = dequeue_pos_.load(std::memory_order_relaxed);
+            auto tail = enqueue_pos_.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        // When T cannot be built from args without throwing, it is built even if the queue turns
+        // out to be full, so a failed push may still have moved from rvalue arguments.
+        template<typename ...Args>
+        bool try_emplace(Args &&... args) {
+            if constexpr (std::is_nothrow_constructible_v<T, Args &&...>) {
+                return claim_and_construct(std::forward<Args>(args)...);
+            } else {
+                return claim_and_construct(T(std::forward<Args>(args)...));
+            }
+        }
+
+        bool try_push(const T &value) { return try_emplace(value); }
+
+        bool try_push(T &&value) { return try_emplace(std::move(value)); }
+
+        // if the assignment to value throws, the popped value is lost but the queue stays usable
+        bool try_pop(T &value) {
+            auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                auto &c = cells_[pos & mask_];
+                auto seq = c.seq_.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        T popped(c.storage_.take());
+                        c.seq_.store(pos + mask_ + 1, std::memory_order_release);
+                        value = std::move(popped);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Pushes the longest prefix of [first, first + count) that fits, returns its length.
+        // Values that cannot be built from *first without throwing, copies of strings say,
+        // are built and pushed one at a time.
+        template<typename It>
+        size_t try_push_bulk(It first, size_t count) {
+            if constexpr (!std::is_nothrow_constructible_v<T, std::iter_reference_t<It>>) {
+                size_t n = 0;
+                for (; n < count && try_emplace(*first); ++n, ++first) {
+                }
+                return n;
+            }
+            auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                // only the producer that claims a free cell writes it, so free cells stay free
+                size_t n = 0;
+                while (n < count && cells_[(pos + n) & mask_].seq_.load(std::memory_order_acquire) == pos + n) {
+                    ++n;
+                }
+                if (n == 0) {
+                    if (cells_[pos & mask_].seq_.load(std::memory_order_acquire) < pos) {
+                        return 0;
+                    }
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                    for (size_t i = 0; i < n; ++i, ++first) {
+                        auto &c = cells_[(pos + i) & mask_];
+                        c.storage_.construct(*first);
+                        c.seq_.store(pos + i + 1, std::memory_order_release);
+                    }
+                    return n;
+                }
+            }
+        }
+
+        // Pops up to max values into out, returns how many. If writing to out throws, the values
+        // claimed after the failing one are dropped, so producers can reuse their cells.
+        template<typename OutIt>
+        size_t try_pop_bulk(OutIt out, size_t max) {
+            auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                size_t n = 0;
+                while (n < max && cells_[(pos + n) & mask_].seq_.load(std::memory_order_acquire) == pos + n + 1) {
+                    ++n;
+                }
+                if (n == 0) {
+                    if (cells_[pos & mask_].seq_.load(std::memory_order_acquire) < pos + 1) {
+                        return 0;
+                    }
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                    size_t i = 0;
+                    try {
+                        for (; i < n; ++i) {
+                            auto &c = cells_[(pos + i) & mask_];
+                            T popped(c.storage_.take());
+                            c.seq_.store(pos + i + mask_ + 1, std::memory_order_release);
+                            *out++ = std::move(popped);
+                        }
+                    } catch (...) {
+                        // cell i is released already
+                        for (++i; i < n; ++i) {
+                            auto &c = cells_[(pos + i) & mask_];
+                            c.storage_.get().~T();
+                            c.seq_.store(pos + i + mask_ + 1, std::memory_order_release);
+                        }
+                        throw;
+                    }
+                    return n;
+                }
+            }
+        }
+
+    private:
+        // only called with arguments T is built from without throwing, a claimed cell cannot be
+        // given back, consumers would wait for it forever
+        template<typename ...Args>
+        bool claim_and_construct(Args &&... args) {
+            auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                auto &c = cells_[pos & mask_];
+                auto seq = c.seq_.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        c.storage_.construct(std::forward<Args>(args)...);
+                        c.seq_.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    // full, the cell still holds the value of the previous lap
+                    return false;
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        const size_t mask_;
+        std::unique_ptr<cell[]> cells_;
+        alignas(std::hardware_destructive_interference_size) std::atomic<size_t> enqueue_pos_{0};
+        alignas(std::hardware_destructive_interference_size) std::atomic<size_t> dequeue_pos_{0};
+    };
+
+    // Unbounded MPMC queue of fixed size segments. Producers and consumers claim cells with a
+    // fetch_add on the segment's counters and a consumer that overtakes a producer poisons the
+    // cell, so the producer moves on. Segments are linked Michael-Scott style, a consumer that
+    // moves the head past a segment retires it through Reclaim, since producers and consumers
+    // that are still inside it hold it with a guard, a hazard pointer by default.
+    template<typename T, size_t SegmentSize = 256, reclamation_policy Reclaim = hazp_reclamation>
+    class unbounded_queue {
+        enum cell_state : uint8_t {
+            EMPTY,
+            // claimed by a producer that is constructing the value
+            WRITING,
+            READY,
+            // consumed, or poisoned by a consumer that got there first
+            TAKEN,
+        };
+
+        struct cell {
+            std::atomic<uint8_t> state_{EMPTY};
+            detail::queue_storage<T> storage_;
+        };
+
+        struct segment {
+            ~segment() {
+                for (auto &c: cells_) {
+                    if (c.state_.load(std::memory_order_relaxed) == READY) {
+                        c.storage_.get().~T();
+                    }
+                }
+            }
+
+            alignas(std::hardware_destructive_interference_size) std::atomic<size_t> enqueue_idx_{0};
+            alignas(std::hardware_destructive_interference_size) std::atomic<size_t> dequeue_idx_{0};
+            std::atomic<segment *> next_{nullptr};
+            cell cells_[SegmentSize];
+        };
+
+    public:
+        unbounded_queue() {
+            auto seg = new segment();
+            head_.store(seg, std::memory_order_relaxed);
+            tail_.store(seg, std::memory_order_relaxed);
+        }
+
+        // no other thread may use the queue anymore
+        ~unbounded_queue() {
+            auto seg = head_.load(std::memory_order_relaxed);
+            while (seg != nullptr) {
+                auto next = seg->next_.load(std::memory_order_relaxed);
+                delete seg;
+                seg = next;
+            }
+        }
+
+        unbounded_queue(const unbounded_queue &) = delete;
+
+        unbounded_queue &operator=(const unbounded_queue &) = delete;
+
+        template<typename ...Args>
+        void emplace(Args &&... args) {
+            typename Reclaim::guard guard;
+            while (true) {
+                auto seg = guard.protect(tail_);
+                auto idx = seg->enqueue_idx_.fetch_add(1, std::memory_order_acq_rel);
+                if (idx >= SegmentSize) [[unlikely]] {
+                    advance_tail(seg);
+                    continue;
+                }
+                if (try_put(seg->cells_[idx], std::forward<Args>(args)...)) {
+                    return;
+                }
+            }
+        }
+
+        void push(const T &value) { emplace(value); }
+
+        void push(T &&value) { emplace(std::move(value)); }
+
+        bool try_pop(T &value) {
+            return try_pop_bulk(&value, 1) == 1;
+        }
+
+        // pushes every value of [first, last), claiming a run of cells per segment at once
+        template<typename It>
+        void push_bulk(It first, It last) {
+            typename Reclaim::guard guard;
+            auto remaining = static_cast<size_t>(std::distance(first, last));
+            while (remaining != 0) {
+                auto seg = guard.protect(tail_);
+                auto n = std::min(remaining, SegmentSize);
+                auto idx = seg->enqueue_idx_.fetch_add(n, std::memory_order_acq_rel);
+                auto end = std::min(idx + n, SegmentSize);
+                for (; idx < end && remaining != 0; ++idx) {
+                    // a poisoned cell keeps the value for the next one
+                    if (try_put(seg->cells_[idx], *first)) {
+                        ++first;
+                        --remaining;
+                    }
+                }
+                if (remaining != 0) {
+                    advance_tail(seg);
+                }
+            }
+        }
+
+        // pops up to max values into out, returns how many, 0 if the queue looked empty
+        template<typename OutIt>
+        size_t try_pop_bulk(OutIt out, size_t max) {
+            typename Reclaim::guard guard;
+            size_t popped = 0;
+            while (popped < max) {
+                auto seg = guard.protect(head_);
+                auto deq = seg->dequeue_idx_.load(std::memory_order_acquire);
+                auto enq = std::min(seg->enqueue_idx_.load(std::memory_order_acquire), SegmentSize);
+                if (deq >= SegmentSize) {
+                    if (!advance_head(seg)) {
+                        break;
+                    }
+                    continue;
+                }
+                if (deq >= enq) {
+                    // nothing claimed past the consumers, the queue is empty
+                    break;
+                }
+                auto n = std::min(max - popped, enq - deq);
+                auto idx = seg->dequeue_idx_.fetch_add(n, std::memory_order_acq_rel);
+                auto end = std::min(idx + n, SegmentSize);
+                for (; idx < end; ++idx) {
+                    if (try_take(seg->cells_[idx], out)) {
+                        ++popped;
+                    }
+                }
+            }
+            return popped;
+        }
+
+        // approximate, only looks at the head segment and whether more follow
+        bool empty() {
+            typename Reclaim::guard guard;
+            auto seg = guard.protect(head_);
+            auto deq = seg->dequeue_idx_.load(std::memory_order_acquire);
+            auto enq = std::min(seg->enqueue_idx_.load(std::memory_order_acquire), SegmentSize);
+            return deq >= enq && seg->next_.load(std::memory_order_acquire) == nullptr;
+        }
+
+    private:
+        template<typename ...Args>
+        static bool try_put(cell &c, Args &&... args) {
+            uint8_t expected = EMPTY;
+            if (!c.state_.compare_exchange_strong(expected, WRITING, std::memory_order_acquire,
+                                                  std::memory_order_relaxed)) {
+                return false;
+            }
+            try {
+                c.storage_.construct(std::forward<Args>(args)...);
+            } catch (...) {
+                // poisoned, the consumer of this cell skips it like one it overtook
+                c.state_.store(TAKEN, std::memory_order_release);
+                throw;
+            }
+            c.state_.store(READY, std::memory_order_release);
+            return true;
+        }
+
+        template<typename OutIt>
+        static bool try_take(cell &c, OutIt &out) {
+            auto state = c.state_.load(std::memory_order_acquire);
+            while (true) {
+                if (state == EMPTY) {
+                    // the producer that claimed this cell has not arrived yet, make it move on
+                    if (c.state_.compare_exchange_strong(state, TAKEN, std::memory_order_acquire,
+                                                         std::memory_order_acquire)) {
+                        return false;
+                    }
+                } else if (state == WRITING) {
+                    // the value is being constructed and is ours
+                    state = c.state_.load(std::memory_order_acquire);
+                } else if (state == TAKEN) {
+                    // the producer failed to construct the value
+                    return false;
+                } else {
+                    assert(state == READY);
+                    *out++ = c.storage_.take();
+                    c.state_.store(TAKEN, std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+
+        // seg is full, link a new segment if nobody did and move the tail past seg
+        void advance_tail(segment *seg) {
+            auto next = seg->next_.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                auto fresh = new segment();
+                if (seg->next_.compare_exchange_strong(next, fresh, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+                    next = fresh;
+                } else {
+                    delete fresh;
+                }
+            }
+            tail_.compare_exchange_strong(seg, next, std::memory_order_acq_rel, std::memory_order_relaxed);
+        }
+
+        // every cell of seg is claimed by a consumer, returns false if no segment follows
+        bool advance_head(segment *seg) {
+            auto next = seg->next_.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                return false;
+            }
+            // the tail must not lag behind the head, or a producer could still load seg from it
+            auto tail = seg;
+            tail_.compare_exchange_strong(tail, next, std::memory_order_acq_rel, std::memory_order_relaxed);
+            auto head = seg;
+            if (head_.compare_exchange_strong(head, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                Reclaim::retire(seg);
+            }
+            return true;
+        }
+
+        alignas(std::hardware_destructive_interference_size) std::atomic<segment *> head_{nullptr};
+        alignas(std::hardware_destructive_interference_size) std::atomic<segment *> tail_{nullptr};
+    };
+
+} // namespace alp_utils
@@ -64,17 +64,17 @@ namespace alp_utils {
     private:
         constexpr size_t parent_index(size_t i) const {
             if constexpr (is_power_of_two) {
-                return (i - 1) / d;
-            } else {
                 return (i - 1) >> d_shift;
+            } else {
+                return (i - 1) / d;
             }
         }
 
         constexpr size_t child_index(size_t i, size_t k) const {
             if constexpr (is_power_of_two) {
-                return d * i + k + 1;
-            } else {
                 return (i << d_shift) + (k + 1);
+            } else {
+                return d * i + k + 1;
             }
         }
 
@@ -115,13 +115,13 @@ namespace alp_utils {
                     index = extreme_child;
                 }
             } else {
-                const size_t min_child = child_index(size, 0);
+                // nodes before full_end have all d children in range
+                const size_t full_end = size > d ? (size - 1 - d) / d + 1 : 0;
 
-                while (index < min_child) {
-                    size_t extreme_child = min_child;
-                    for (uint16_t k = 0; k < d; ++k) {
+                while (index < full_end) {
+                    size_t extreme_child = child_index(index, 0);
+                    for (uint16_t k = 1; k < d; ++k) {
                         size_t current_child = child_index(index, k);
-                        if (current_child >= size) break;
                         extreme_child = cmp_(data_[extreme_child], data_[current_child])
                                         ? current_child : extreme_child;
                     }
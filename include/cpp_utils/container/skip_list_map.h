@@ -0,0 +1,459 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <utility>
+
+#include "../concurrency/hazard_ptr.h"
+
+namespace alp_utils {
+
+    // Lock-free ordered map (Fraser / Herlihy-Shavit skip list) whose nodes are protected by
+    // hazard pointers. A node is removed by marking its links top down, the mark of level 0
+    // decides which erase wins. Traversals unlink marked nodes they meet and only advance from
+    // an unmarked link, so every node they protect is still linked and cannot be retired.
+    // A node is retired by the last of its inserter and its remover to finish, after both have
+    // unlinked it from every level they could have linked it to. Entries are immutable once
+    // inserted, erase and insert again to replace a value.
+    template<typename Key, typename Value, typename Compare = std::less<Key>>
+    class skip_list_map {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<const Key, Value>;
+        using key_compare = Compare;
+        using size_type = size_t;
+
+        static constexpr int kMaxHeight = 16;
+
+    private:
+        struct node;
+
+        struct node_deleter {
+            void operator()(node *n) const { node::destroy(n); }
+        };
+
+        // the links live right after the node, a node only pays for its own height
+        struct node : hazp::hazptr_obj_base<node, node_deleter> {
+            template<typename ...Args>
+            static node *create(uint8_t height, Args &&... args) {
+                auto mem = ::operator new(sizeof(node) + height * sizeof(std::atomic<node *>));
+                auto n = new(mem) node(height, std::forward<Args>(args)...);
+                for (uint8_t l = 0; l < height; ++l) {
+                    new(n->links() + l) std::atomic<node *>(nullptr);
+                }
+                return n;
+            }
+
+            static void destroy(node *n) {
+                n->~node();
+                ::operator delete(n);
+            }
+
+            template<typename ...Args>
+            explicit node(uint8_t height, Args &&... args) : value_(std::forward<Args>(args)...), height_(height) {}
+
+            std::atomic<node *> *links() noexcept {
+                return reinterpret_cast<std::atomic<node *> *>(this + 1);
+            }
+
+            const key_type &key() const noexcept { return value_.first; }
+
+            value_type value_;
+            // inserter and remover, the last one to let go retires the node
+            std::atomic<uint8_t> owners_{2};
+            uint8_t height_;
+        };
+
+        static bool is_marked(node *ptr) noexcept {
+            return (reinterpret_cast<uintptr_t>(ptr) & 1U) != 0;
+        }
+
+        static node *marked(node *ptr) noexcept {
+            return reinterpret_cast<node *>(reinterpret_cast<uintptr_t>(ptr) | 1U);
+        }
+
+        static node *unmarked(node *ptr) noexcept {
+            return reinterpret_cast<node *>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t{1});
+        }
+
+        // hazard pointers of insert and erase, every level keeps its predecessor and successor
+        // protected until the links are updated
+        struct update_hazards {
+            update_hazards() : preds_(hazp::make_hazard_ptr<kMaxHeight>()),
+                               succs_(hazp::make_hazard_ptr<kMaxHeight>()),
+                               curr_(hazp::make_hazard_ptr()) {}
+
+            std::array<hazp::hazard_ptr, kMaxHeight> preds_;
+            std::array<hazp::hazard_ptr, kMaxHeight> succs_;
+            hazp::hazard_ptr curr_;
+        };
+
+        // operations do not nest, so a thread reuses the same slots for every map of this type
+        static update_hazards &local_hazards() {
+            static thread_local update_hazards hazards;
+            return hazards;
+        }
+
+    public:
+        // Forward iterator over the live map, not a snapshot, it holds two hazard pointers so
+        // its entry stays valid even if it is erased meanwhile. Moving past an erased entry
+        // continues at the first entry greater than its key.
+        class const_iterator {
+        public:
+            using value_type = skip_list_map::value_type;
+            using reference = const value_type &;
+            using pointer = const value_type *;
+            using difference_type = std::ptrdiff_t;
+
+            const_iterator() = default;
+
+            const_iterator(const_iterator &&) noexcept = default;
+
+            const_iterator &operator=(const_iterator &&) noexcept = default;
+
+            reference operator*() const noexcept { return curr_->value_; }
+
+            pointer operator->() const noexcept { return &curr_->value_; }
+
+            const_iterator &operator++() {
+                // an unmarked link means curr is still linked, so is its successor
+                auto next = pred_hp_.protect(curr_->links()[0], &unmarked);
+                if (!is_marked(next)) [[likely]] {
+                    swap(pred_hp_, curr_hp_);
+                    curr_ = next;
+                } else {
+                    // the search reuses the slot protecting curr
+                    auto key = curr_->key();
+                    curr_ = map_->search(key, true, pred_hp_, curr_hp_);
+                }
+                return *this;
+            }
+
+            bool operator==(const const_iterator &other) const noexcept { return curr_ == other.curr_; }
+
+            bool operator!=(const const_iterator &other) const noexcept { return curr_ != other.curr_; }
+
+        private:
+            friend class skip_list_map;
+
+            explicit const_iterator(const skip_list_map *map) : map_(map) {
+                auto hazards = hazp::make_hazard_ptr<2>();
+                pred_hp_ = std::move(hazards[0]);
+                curr_hp_ = std::move(hazards[1]);
+            }
+
+            const skip_list_map *map_{nullptr};
+            node *curr_{nullptr};
+            hazp::hazard_ptr pred_hp_{};
+            hazp::hazard_ptr curr_hp_{};
+        };
+
+        skip_list_map() = default;
+
+        explicit skip_list_map(const Compare &comp) : comp_(comp) {}
+
+        skip_list_map(const skip_list_map &) = delete;
+
+        skip_list_map &operator=(const skip_list_map &) = delete;
+
+        // no other thread may use the map anymore, removed nodes are already retired
+        ~skip_list_map() {
+            auto n = head_[0].load(std::memory_order_acquire);
+            while (n != nullptr) {
+                auto next = unmarked(n->links()[0].load(std::memory_order_relaxed));
+                node::destroy(n);
+                n = next;
+            }
+        }
+
+        // approximate while other threads insert or erase
+        size_type size() const noexcept {
+            // an erase may count before the insert it races with
+            auto size = size_.load(std::memory_order_relaxed);
+            return size < 0 ? 0 : static_cast<size_type>(size);
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        bool insert(const value_type &value) {
+            return emplace(value.first, value.second);
+        }
+
+        // returns false and constructs nothing if the key is present
+        template<typename ...Args>
+        bool emplace(const key_type &key, Args &&... args) {
+            auto &hazards = local_hazards();
+            std::array<node *, kMaxHeight> preds{};
+            std::array<node *, kMaxHeight> succs{};
+            node *n = nullptr;
+            while (true) {
+                if (find(key, preds, succs, hazards)) {
+                    if (n != nullptr) {
+                        node::destroy(n);
+                    }
+                    return false;
+                }
+                if (n == nullptr) {
+                    n = node::create(random_height(), std::piecewise_construct, std::forward_as_tuple(key),
+                                     std::forward_as_tuple(std::forward<Args>(args)...));
+                }
+                for (uint8_t l = 0; l < n->height_; ++l) {
+                    n->links()[l].store(succs[l], std::memory_order_relaxed);
+                }
+                auto expected = succs[0];
+                if (links(preds[0])[0].compare_exchange_strong(expected, n, std::memory_order_release,
+                                                               std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            size_.fetch_add(1, std::memory_order_relaxed);
+            link_upper_levels(n, preds, succs, hazards);
+            return true;
+        }
+
+        bool erase(const key_type &key) {
+            auto &hazards = local_hazards();
+            std::array<node *, kMaxHeight> preds{};
+            std::array<node *, kMaxHeight> succs{};
+            if (!find(key, preds, succs, hazards)) {
+                return false;
+            }
+            // protected by succs_[0] until the next find
+            auto victim = succs[0];
+            for (int l = victim->height_ - 1; l > 0; --l) {
+                auto succ = victim->links()[l].load(std::memory_order_acquire);
+                while (!is_marked(succ) &&
+                       !victim->links()[l].compare_exchange_weak(succ, marked(succ), std::memory_order_acq_rel,
+                                                                 std::memory_order_acquire)) {
+                }
+            }
+            auto succ = victim->links()[0].load(std::memory_order_acquire);
+            while (true) {
+                if (is_marked(succ)) {
+                    // another erase won
+                    return false;
+                }
+                if (victim->links()[0].compare_exchange_weak(succ, marked(succ), std::memory_order_acq_rel,
+                                                             std::memory_order_acquire)) {
+                    break;
+                }
+            }
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            // unlinks the victim from every level
+            find(key, preds, succs, hazards);
+            release(victim);
+            return true;
+        }
+
+        // borrows the slots of insert and erase instead of making an iterator
+        bool contains(const key_type &key) const {
+            auto &hazards = local_hazards();
+            auto curr = search(key, false, hazards.preds_[0], hazards.curr_);
+            auto found = curr != nullptr && !comp_(key, curr->key());
+            hazards.preds_[0].reset();
+            hazards.curr_.reset();
+            return found;
+        }
+
+        const_iterator find(const key_type &key) const {
+            auto it = lower_bound(key);
+            if (it.curr_ != nullptr && comp_(key, it.curr_->key())) {
+                return end();
+            }
+            return it;
+        }
+
+        // first entry not less than key
+        const_iterator lower_bound(const key_type &key) const {
+            const_iterator it(this);
+            it.curr_ = search(key, false, it.pred_hp_, it.curr_hp_);
+            return it;
+        }
+
+        // first entry greater than key
+        const_iterator upper_bound(const key_type &key) const {
+            const_iterator it(this);
+            it.curr_ = search(key, true, it.pred_hp_, it.curr_hp_);
+            return it;
+        }
+
+        const_iterator begin() const {
+            const_iterator it(this);
+            auto first = it.curr_hp_.protect(head_[0], &unmarked);
+            if (first == nullptr || !is_marked(first->links()[0].load(std::memory_order_acquire))) [[likely]] {
+                it.curr_ = first;
+                return it;
+            }
+            // the first entry is being erased, search past it
+            auto key = first->key();
+            it.curr_ = search(key, true, it.pred_hp_, it.curr_hp_);
+            return it;
+        }
+
+        const_iterator end() const noexcept { return {}; }
+
+    private:
+        std::atomic<node *> *links(node *pred) const noexcept {
+            return pred == nullptr ? head_.data() : pred->links();
+        }
+
+        static uint8_t random_height() {
+            static thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1U;
+            // xorshift64, each level is taken with probability 1/2
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return static_cast<uint8_t>(std::countr_one(state) % kMaxHeight + 1);
+        }
+
+        // Loads the link of pred at level into curr under hp, fails if pred was marked at that level
+        // so its successor may already be unlinked from everything else. On entry curr is a node
+        // that stays protected for the rest of the traversal or by hp itself, a link pointing
+        // to it or to nothing needs no new publication and no fence.
+        bool load_next(node *pred, int level, hazp::hazard_ptr &hp, node *&curr) const {
+            auto next = links(pred)[level].load(std::memory_order_acquire);
+            if (next == nullptr || next == curr) [[likely]] {
+                hp.reset_protection(next);
+                curr = next;
+                return true;
+            }
+            next = hp.protect(links(pred)[level], &unmarked);
+            if (is_marked(next)) [[unlikely]] {
+                return false;
+            }
+            curr = next;
+            return true;
+        }
+
+        // Fills preds and succs for every level, each protected by the matching slot of hazards,
+        // and unlinks the marked nodes on the way. Returns whether succs[0] holds key.
+        bool find(const key_type &key, std::array<node *, kMaxHeight> &preds, std::array<node *, kMaxHeight> &succs,
+                  update_hazards &hazards) const {
+        retry:
+            node *pred = nullptr;
+            for (int l = kMaxHeight - 1; l >= 0; --l) {
+                // pred is protected by the slot of the level above, which does not change anymore
+                hazards.preds_[l].reset_protection(pred);
+                // the successor of the level above is protected by its slot until we return
+                node *curr = l + 1 < kMaxHeight ? succs[l + 1] : nullptr;
+                if (!load_next(pred, l, hazards.curr_, curr)) {
+                    goto retry;
+                }
+                while (curr != nullptr) {
+                    auto succ = curr->links()[l].load(std::memory_order_acquire);
+                    if (is_marked(succ)) {
+                        auto expected = curr;
+                        if (!links(pred)[l].compare_exchange_strong(expected, unmarked(succ), std::memory_order_acq_rel,
+                                                                    std::memory_order_acquire) ||
+                            !load_next(pred, l, hazards.curr_, curr)) {
+                            goto retry;
+                        }
+                        continue;
+                    }
+                    if (!comp_(curr->key(), key)) {
+                        break;
+                    }
+                    pred = curr;
+                    swap(hazards.preds_[l], hazards.curr_);
+                    if (!load_next(pred, l, hazards.curr_, curr)) {
+                        goto retry;
+                    }
+                }
+                preds[l] = pred;
+                succs[l] = curr;
+                swap(hazards.succs_[l], hazards.curr_);
+            }
+            return succs[0] != nullptr && !comp_(key, succs[0]->key());
+        }
+
+        // Like find but with two hazard pointers, returns the first node not less than key, or
+        // greater than key when strict, protected by curr_hp.
+        node *search(const key_type &key, bool strict, hazp::hazard_ptr &pred_hp, hazp::hazard_ptr &curr_hp) const {
+        retry:
+            node *pred = nullptr;
+            node *curr = nullptr;
+            pred_hp.reset();
+            for (int l = kMaxHeight - 1; l >= 0; --l) {
+                if (!load_next(pred, l, curr_hp, curr)) {
+                    goto retry;
+                }
+                while (curr != nullptr) {
+                    auto succ = curr->links()[l].load(std::memory_order_acquire);
+                    if (is_marked(succ)) {
+                        auto expected = curr;
+                        if (!links(pred)[l].compare_exchange_strong(expected, unmarked(succ), std::memory_order_acq_rel,
+                                                                    std::memory_order_acquire) ||
+                            !load_next(pred, l, curr_hp, curr)) {
+                            goto retry;
+                        }
+                        continue;
+                    }
+                    if (strict ? comp_(key, curr->key()) : !comp_(curr->key(), key)) {
+                        break;
+                    }
+                    pred = curr;
+                    swap(pred_hp, curr_hp);
+                    if (!load_next(pred, l, curr_hp, curr)) {
+                        goto retry;
+                    }
+                }
+            }
+            return curr;
+        }
+
+        void link_upper_levels(node *n, std::array<node *, kMaxHeight> &preds, std::array<node *, kMaxHeight> &succs,
+                               update_hazards &hazards) {
+            for (uint8_t l = 1; l < n->height_; ++l) {
+                while (true) {
+                    // point n at the current successor first, a mark means n is being erased
+                    auto next = n->links()[l].load(std::memory_order_acquire);
+                    if (is_marked(next)) {
+                        goto done;
+                    }
+                    if (next != succs[l] &&
+                        !n->links()[l].compare_exchange_strong(next, succs[l], std::memory_order_acq_rel,
+                                                               std::memory_order_acquire)) {
+                        if (is_marked(next)) {
+                            goto done;
+                        }
+                        find(n->key(), preds, succs, hazards);
+                        continue;
+                    }
+                    auto expected = succs[l];
+                    if (links(preds[l])[l].compare_exchange_strong(expected, n, std::memory_order_release,
+                                                                   std::memory_order_relaxed)) {
+                        break;
+                    }
+                    find(n->key(), preds, succs, hazards);
+                    if (is_marked(n->links()[0].load(std::memory_order_acquire))) {
+                        goto done;
+                    }
+                }
+            }
+        done:
+            // the remover may have cleaned up before we linked a level, so unlink it again
+            if (is_marked(n->links()[0].load(std::memory_order_acquire))) {
+                find(n->key(), preds, succs, hazards);
+            }
+            release(n);
+        }
+
+        static void release(node *n) {
+            if (n->owners_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                n->retire();
+            }
+        }
+
+        [[no_unique_address]] Compare comp_{};
+        mutable std::array<std::atomic<node *>, kMaxHeight> head_{};
+        std::atomic<int64_t> size_{0};
+    };
+
+} // namespace alp_utils
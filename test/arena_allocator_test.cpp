@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/allocator/allocator_concepts.h>
+#include <cpp_utils/allocator/arena_allocator.h>
+#include <cpp_utils/container/avl_map.h>
+#include <cpp_utils/container/nd_heap.h>
+
+#include <list>
+#include <vector>
+
+using alp_utils::Arena;
+using alp_utils::arena_allocator;
+
+static_assert(alp_utils::is_std_alloc_v<arena_allocator<int>, int>);
+
+TEST(ArenaAllocatorTest, rebindKeepsArena) {
+    Arena arena, other;
+    arena_allocator<int> a(arena);
+    arena_allocator<double> b(a);
+    ASSERT_EQ(b.arena(), &arena);
+    ASSERT_TRUE(a == b);
+    ASSERT_TRUE(a != arena_allocator<int>(other));
+}
+
+TEST(ArenaAllocatorTest, alignment) {
+    Arena arena;
+    arena_allocator<char> chars(arena);
+    arena_allocator<uint64_t> words(arena);
+    for (size_t n = 1; n < 600; n += 7) {
+        chars.allocate(n);
+        auto p = words.allocate(n);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(uint64_t), 0);
+        p[n - 1] = n;
+    }
+
+    struct alignas(32) wide {
+        char data[32];
+    };
+    arena_allocator<wide> wides(arena);
+    for (size_t n = 1; n < 100; n += 13) {
+        chars.allocate(1);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(wides.allocate(n)) % 32, 0);
+    }
+}
+
+TEST(ArenaAllocatorTest, containers) {
+    Arena arena;
+    using pair_alloc = arena_allocator<std::pair<const int, int>>;
+    alp_utils::avl_map<int, int, std::less<int>, pair_alloc> map{pair_alloc(arena)};
+    for (int i = 0; i < 5000; ++i) {
+        map.emplace((i * 7919) % 5000, i);
+    }
+    ASSERT_EQ(map.size(), 5000);
+    ASSERT_EQ(map.begin()->first, 0);
+    ASSERT_TRUE(map.erase(42));
+    ASSERT_EQ(map.size(), 4999);
+
+    alp_utils::nd_heap<int, 4, std::less<int>, arena_allocator<int>> heap{std::less<int>(), arena_allocator<int>(arena)};
+    for (int i = 0; i < 1000; ++i) {
+        heap.push(i);
+    }
+    ASSERT_EQ(heap.top(), 999);
+
+    std::list<int, arena_allocator<int>> list{arena_allocator<int>(arena)};
+    list.assign(100, 1);
+    ASSERT_EQ(list.size(), 100);
+    ASSERT_GT(arena.get_used(), 0);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/allocator/arena.h>
+
+#include <cstring>
+
+using alp_utils::Arena;
+using alp_utils::arena_options;
+
+TEST(ArenaTest, fixedBlocks) {
+    Arena arena;
+    for (int i = 0; i < 100; ++i) {
+        std::memset(arena.allocate(100), i, 100);
+    }
+    // 40 allocations fit a 4 KiB block
+    ASSERT_EQ(arena.get_memory_usage(), 3 * 4096);
+    ASSERT_EQ(arena.get_used(), 100 * 100);
+}
+
+TEST(ArenaTest, geometricGrowth) {
+    Arena arena(arena_options{.block_size = 1024, .max_block_size = 8192, .growth_factor = 2});
+    uint64_t expected = 0;
+    size_t block = 1024;
+    for (int i = 0; i < 6; ++i) {
+        // fills the current block exactly, the next allocation opens a new one
+        arena.allocate(block / 4);
+        expected += block;
+        ASSERT_EQ(arena.get_memory_usage(), expected);
+        for (int j = 1; j < 4; ++j) {
+            arena.allocate(block / 4);
+        }
+        block = std::min<size_t>(block * 2, 8192);
+    }
+}
+
+TEST(ArenaTest, unalignedBlockSize) {
+    // block sizes are rounded up to Arena::alignment, grown ones too
+    Arena arena(arena_options{.block_size = 4100, .max_block_size = 20000, .growth_factor = 3});
+    for (int i = 0; i < 200; ++i) {
+        auto p = arena.allocate_aligned(24);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % Arena::alignment, 0);
+        std::memset(p, i, 24);
+        arena.allocate(3);
+    }
+    ASSERT_EQ(arena.get_memory_usage() % Arena::alignment, 0);
+}
+
+TEST(ArenaTest, largeAllocationsGetTheirOwnBlock) {
+    Arena arena(arena_options{.block_size = 4096});
+    arena.allocate(8);
+    auto big = arena.allocate_aligned(10000);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(big) % Arena::alignment, 0);
+    std::memset(big, 1, 10000);
+    // the small block keeps serving small requests
+    arena.allocate(8);
+    ASSERT_EQ(arena.get_memory_usage(), 4096 + 10000 + Arena::alignment);
+}
+
+TEST(ArenaTest, hugePages) {
+    constexpr size_t kHugePage = 2 << 20;
+    Arena arena(arena_options{.block_size = 1 << 20, .huge_pages = true});
+    auto p = arena.allocate(64);
+    std::memset(p, 1, 64);
+#if defined(__linux__)
+    // mapped blocks are rounded up to and aligned at a huge page
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % kHugePage, 0);
+    ASSERT_EQ(arena.get_memory_usage(), kHugePage);
+#endif
+    auto big = arena.allocate(3 * kHugePage);
+    std::memset(big, 2, 3 * kHugePage);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/container/concurrent_hash_map.h>
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using alp_utils::concurrent_hash_map;
+
+TEST(ConcurrentHashMapTest, insertFindErase) {
+    concurrent_hash_map<int, std::string> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.insert({1, "one"}));
+    ASSERT_TRUE(map.emplace(2, "two"));
+    ASSERT_FALSE(map.emplace(2, "deux"));
+    ASSERT_EQ(map.size(), 2);
+
+    auto ptr = map.find(2);
+    ASSERT_TRUE(ptr);
+    ASSERT_EQ(ptr->second, "two");
+    ASSERT_FALSE(map.find(3));
+    ASSERT_EQ(map.get(1), "one");
+    ASSERT_EQ(map.get(3), std::nullopt);
+
+    ASSERT_FALSE(map.insert_or_assign(2, "deux"));
+    ASSERT_EQ(map.get(2), "deux");
+    // the handle still holds the replaced entry
+    ASSERT_EQ(ptr->second, "two");
+
+    ASSERT_TRUE(map.erase(1));
+    ASSERT_FALSE(map.erase(1));
+    ASSERT_FALSE(map.contains(1));
+    ASSERT_TRUE(map.insert_or_assign(1, "un"));
+    ASSERT_EQ(map.size(), 2);
+}
+
+TEST(ConcurrentHashMapTest, growsIncrementally) {
+    concurrent_hash_map<int, int> map(4);
+    std::unordered_map<int, int> expected;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(gen() % 5000);
+        switch (gen() % 3) {
+            case 0:
+                ASSERT_EQ(map.emplace(key, i), expected.emplace(key, i).second);
+                break;
+            case 1:
+                ASSERT_EQ(map.insert_or_assign(key, i), !expected.contains(key));
+                expected[key] = i;
+                break;
+            default:
+                ASSERT_EQ(map.erase(key), expected.erase(key) == 1);
+        }
+    }
+    ASSERT_EQ(map.size(), expected.size());
+    ASSERT_GT(map.bucket_count(), 4);
+    for (int key = 0; key < 5000; ++key) {
+        auto it = expected.find(key);
+        auto value = map.get(key);
+        ASSERT_EQ(value.has_value(), it != expected.end());
+        if (value) {
+            ASSERT_EQ(*value, it->second);
+        }
+    }
+}
+
+TEST(ConcurrentHashMapTest, readersDuringResize) {
+    constexpr int kWriters = 4;
+    constexpr int kPerWriter = 20000;
+    concurrent_hash_map<int, int> map(2);
+    std::atomic<bool> done{false};
+
+    // keys below zero are never erased, readers must always find them
+    for (int key = -1; key >= -64; --key) {
+        map.emplace(key, key);
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                for (int key = -1; key >= -64; --key) {
+                    auto value = map.get(key);
+                    ASSERT_TRUE(value.has_value());
+                    ASSERT_EQ(*value, key);
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kWriters; ++t) {
+        writers.emplace_back([&, t] {
+            for (int i = 0; i < kPerWriter; ++i) {
+                int key = t * kPerWriter + i;
+                ASSERT_TRUE(map.emplace(key, key));
+                if (i % 2 == 1) {
+                    ASSERT_TRUE(map.erase(key - 1));
+                }
+            }
+        });
+    }
+    for (auto &t: writers) {
+        t.join();
+    }
+    done.store(true);
+    for (auto &t: threads) {
+        t.join();
+    }
+    ASSERT_EQ(map.size(), 64 + kWriters * kPerWriter / 2);
+    for (int key = 0; key < kWriters * kPerWriter; ++key) {
+        ASSERT_EQ(map.contains(key), key % 2 == 1);
+    }
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/concurrency/double_buffer.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using alp_utils::double_buffer;
+
+struct Pair {
+    int first{0};
+    int second{0};
+};
+
+TEST(DoubleBufferTest, readAfterUpdate) {
+    double_buffer<std::vector<int>> buffer(3, 1);
+    ASSERT_EQ(buffer.read()->size(), 3);
+
+    buffer.update([](std::vector<int> &v) { v.push_back(2); });
+    auto handle = buffer.read();
+    ASSERT_EQ(handle->size(), 4);
+    ASSERT_EQ(handle->back(), 2);
+}
+
+TEST(DoubleBufferTest, writerWaitsForReader) {
+    double_buffer<int> buffer(1);
+    auto handle = buffer.read();
+
+    std::atomic<bool> updated{false};
+    std::thread writer([&] {
+        buffer.update([](int &v) { ++v; });
+        updated.store(true);
+    });
+    // new readers see the update as soon as it is published
+    while (*buffer.read() != 2) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // but update cannot return before it has been applied to the copy we still hold
+    ASSERT_FALSE(updated.load());
+    ASSERT_EQ(*handle, 1);
+
+    handle.reset();
+    writer.join();
+    ASSERT_TRUE(updated.load());
+    ASSERT_EQ(*buffer.read(), 2);
+
+    buffer.update([](int &v) { ++v; });
+    ASSERT_EQ(*buffer.read(), 3);
+}
+
+TEST(DoubleBufferTest, updateIsDoneOnReturn) {
+    double_buffer<int> buffer(0);
+    int calls = 0;
+    buffer.update([&calls](int &v) {
+        ++calls;
+        ++v;
+    });
+    // applied to both copies already, later writes never call it again
+    ASSERT_EQ(calls, 2);
+
+    std::vector<double_buffer<int>::operation> ops;
+    ops.emplace_back([&calls](int &v) {
+        ++calls;
+        v += 10;
+    });
+    buffer.update_batch(std::move(ops));
+    ASSERT_EQ(calls, 4);
+
+    buffer.update([](int &v) { ++v; });
+    buffer.update([](int &v) { ++v; });
+    ASSERT_EQ(calls, 4);
+    ASSERT_EQ(*buffer.read(), 13);
+}
+
+TEST(DoubleBufferTest, bothCopiesSeeEveryUpdate) {
+    double_buffer<std::vector<int>> buffer;
+    for (int i = 0; i < 5; ++i) {
+        buffer.update([i](std::vector<int> &v) { v.push_back(i); });
+        ASSERT_EQ(buffer.read()->size(), i + 1);
+    }
+    ASSERT_EQ(buffer.read()->back(), 4);
+}
+
+TEST(DoubleBufferTest, concurrentReadUpdate) {
+    constexpr int kReaders = 4;
+    constexpr int kUpdates = 10000;
+    double_buffer<Pair> buffer;
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                auto handle = buffer.read();
+                ASSERT_EQ(handle->first, handle->second);
+                ASSERT_GE(handle->first, last);
+                last = handle->first;
+            }
+        });
+    }
+
+    for (int i = 0; i < kUpdates; ++i) {
+        buffer.update([](Pair &p) {
+            ++p.first;
+            ++p.second;
+        });
+    }
+    done.store(true);
+    for (auto &t: readers) {
+        t.join();
+    }
+    ASSERT_EQ(buffer.read()->first, kUpdates);
+}
+
+TEST(DoubleBufferTest, enqueueAndFlush) {
+    double_buffer<std::vector<int>> buffer;
+    for (int i = 0; i < 10; ++i) {
+        buffer.enqueue([i](std::vector<int> &v) { v.push_back(i); });
+    }
+    ASSERT_EQ(buffer.pending(), 10);
+    ASSERT_TRUE(buffer.read()->empty());
+
+    buffer.flush();
+    ASSERT_EQ(buffer.pending(), 0);
+    auto handle = buffer.read();
+    ASSERT_EQ(handle->size(), 10);
+    ASSERT_EQ(handle->front(), 0);
+    ASSERT_EQ(handle->back(), 9);
+    handle.reset();
+
+    // the batch reached both copies in the flush
+    buffer.update([](std::vector<int> &v) { v.push_back(10); });
+    ASSERT_EQ(buffer.read()->size(), 11);
+}
+
+TEST(DoubleBufferTest, sizeTrigger) {
+    double_buffer<int> buffer(0);
+    buffer.set_max_pending(4);
+    for (int i = 0; i < 10; ++i) {
+        buffer.enqueue([](int &v) { ++v; });
+    }
+    ASSERT_EQ(*buffer.read(), 8);
+    ASSERT_EQ(buffer.pending(), 2);
+}
+
+TEST(DoubleBufferTest, backgroundFlusher) {
+    double_buffer<int> buffer(0);
+    {
+        alp_utils::batch_flusher<int> flusher(buffer, std::chrono::milliseconds(1));
+        for (int i = 0; i < 1000; ++i) {
+            buffer.enqueue([](int &v) { ++v; });
+        }
+    }
+    ASSERT_EQ(*buffer.read(), 1000);
+    ASSERT_EQ(buffer.pending(), 0);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/concurrency/epoch_based_reclaimation.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace alp_utils::ebr;
+
+static std::atomic<int> dtors{0};
+
+struct Node {
+    explicit Node(int v = 0) : val(v) {}
+
+    ~Node() { dtors.fetch_add(1); }
+
+    int val;
+    std::atomic<Node *> next{nullptr};
+};
+
+class EbrTest : public testing::Test {
+protected:
+    void SetUp() override {
+        reclaim();
+        dtors.store(0);
+    }
+};
+
+TEST_F(EbrTest, retireAndReclaim) {
+    for (int i = 0; i < 10; ++i) {
+        retire(new Node(i));
+    }
+    ASSERT_EQ(dtors.load(), 0);
+    reclaim();
+    ASSERT_EQ(dtors.load(), 10);
+    ASSERT_EQ(reclaimer::instance().pending(), 0);
+}
+
+TEST_F(EbrTest, customDeleter) {
+    int deleted = 0;
+    auto deleter = [&deleted](Node *node) {
+        ++deleted;
+        delete node;
+    };
+    retire(new Node, deleter);
+    reclaim();
+    ASSERT_EQ(deleted, 1);
+}
+
+TEST_F(EbrTest, epochAdvancesOnlyPastSeenReaders) {
+    auto &domain = reclaimer::instance();
+    auto epoch = domain.epoch();
+    std::atomic<bool> entered{false};
+    std::atomic<bool> done{false};
+
+    std::thread reader([&] {
+        auto g = make_guard();
+        entered.store(true);
+        while (!done.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    // the reader announced the current epoch, the epoch moves once and then waits for it
+    ASSERT_TRUE(domain.try_advance());
+    ASSERT_FALSE(domain.try_advance());
+    ASSERT_EQ(domain.epoch(), epoch + 1);
+
+    retire(new Node);
+    reclaim();
+    ASSERT_EQ(dtors.load(), 0);
+
+    done.store(true);
+    reader.join();
+    reclaim();
+    ASSERT_EQ(dtors.load(), 1);
+}
+
+TEST_F(EbrTest, readerKeepsRetiredObject) {
+    std::atomic<Node *> cell{new Node(42)};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> retired{false};
+
+    std::thread reader([&] {
+        guard g;
+        auto node = g.protect(cell);
+        entered.store(true);
+        while (!retired.load()) {
+            std::this_thread::yield();
+        }
+        reclaim();
+        ASSERT_EQ(node->val, 42);
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    retire(cell.exchange(new Node(43)));
+    reclaim();
+    ASSERT_EQ(dtors.load(), 0);
+    retired.store(true);
+    reader.join();
+
+    reclaim();
+    ASSERT_EQ(dtors.load(), 1);
+    delete cell.load();
+}
+
+TEST_F(EbrTest, nestedCriticalSection) {
+    auto &domain = reclaimer::instance();
+    enter();
+    enter();
+    exit();
+    ASSERT_TRUE(domain.in_critical_section());
+    exit();
+    ASSERT_FALSE(domain.in_critical_section());
+}
+
+TEST_F(EbrTest, exitedThreadHandsOff) {
+    std::thread t([] {
+        for (int i = 0; i < 10; ++i) {
+            retire(new Node(i));
+        }
+    });
+    t.join();
+    ASSERT_EQ(dtors.load(), 0);
+    reclaim();
+    ASSERT_EQ(dtors.load(), 10);
+}
+
+TEST_F(EbrTest, concurrentReadRetire) {
+    constexpr int kReaders = 4;
+    constexpr int kUpdates = 10000;
+    std::atomic<Node *> cell{new Node(0)};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                guard g;
+                auto node = g.protect(cell);
+                ASSERT_GE(node->val, last);
+                last = node->val;
+            }
+        });
+    }
+
+    for (int i = 1; i <= kUpdates; ++i) {
+        retire(cell.exchange(new Node(i)));
+    }
+    done.store(true);
+    for (auto &t: readers) {
+        t.join();
+    }
+    reclaim();
+    ASSERT_EQ(dtors.load(), kUpdates);
+    delete cell.load();
+}
@@ -335,7 +335,7 @@ void destruction_test(reclaimer &domain) {
         last = new Thing(i, last, &domain);
     }
     domain.retire(last);
-    reclaim();
+    domain.reclaim();
 }
 
 void destruction_protected_test(reclaimer &domain) {
@@ -369,7 +369,7 @@ void destruction_protected_test(reclaimer &domain) {
     RecState state{domain};
     Rec::go(2000, state);
 
-    reclaim();
+    domain.reclaim();
 }
 
 void move_test() {
@@ -926,10 +926,10 @@ TEST_F(HazptrPreInitTest, dsched_virtual) {
 }
 
 TEST(HazptrTest, destruction) {
-//    {
-//        hazptr_domain<> myDomain0;
-//        destruction_test(myDomain0);
-//    }
+    {
+        reclaimer myDomain0;
+        destruction_test(myDomain0);
+    }
     destruction_test(reclaimer::instance());
 }
 
@@ -943,10 +943,10 @@ TEST_F(HazptrPreInitTest, dsched_destruction) {
 }
 
 TEST(HazptrTest, destructionProtected) {
-//    {
-//        hazptr_domain<> myDomain0;
-//        destruction_protected_test(myDomain0);
-//    }
+    {
+        reclaimer myDomain0;
+        destruction_protected_test(myDomain0);
+    }
     destruction_protected_test(reclaimer::instance());
 }
 
@@ -1125,6 +1125,388 @@ TEST(HazptrTest, standardNames) {
 //    hazard_pointer_clean_up<>();
 }
 
+TEST(HazptrTest, protectedSet) {
+    alp_utils::hazp::detail::hazptr_set set;
+    ASSERT_FALSE(set.contains(nullptr));
+
+    std::vector<uintptr_t> vals;
+    for (uintptr_t i = 1; i <= 513; ++i) {
+        vals.push_back(i * 64);
+    }
+    std::reverse(vals.begin(), vals.end());
+
+    for (int round = 0; round < 2; ++round) {
+        set.clear();
+        for (auto val: vals) {
+            set.insert(val);
+        }
+        set.seal();
+        ASSERT_EQ(set.size(), vals.size());
+
+        for (auto val: vals) {
+            ASSERT_TRUE(set.contains(reinterpret_cast<const void *>(val)));
+            ASSERT_FALSE(set.contains(reinterpret_cast<const void *>(val + 8)));
+        }
+        ASSERT_FALSE(set.contains(reinterpret_cast<const void *>(8)));
+    }
+}
+
+TEST(HazptrTest, reclaimKeepsProtected) {
+    c_.clear();
+    constexpr int kProtected = 64;
+    std::vector<std::atomic<Node *>> ptrs(kProtected);
+    std::vector<hazard_ptr> hptrs;
+    for (int i = 0; i < kProtected; ++i) {
+        ptrs[i].store(new Node(i));
+        hptrs.emplace_back(make_hazard_ptr());
+        hptrs.back().protect(ptrs[i]);
+    }
+    for (int i = 0; i < kProtected; ++i) {
+        retire(ptrs[i].load());
+        retire(new Node(i));
+    }
+    reclaim();
+    ASSERT_EQ(c_.dtors(), kProtected);
+    for (auto &h: hptrs) {
+        h.reset();
+    }
+    reclaim();
+    ASSERT_EQ(c_.dtors(), 2 * kProtected);
+}
+
+TEST(HazptrTest, retireBatch) {
+    c_.clear();
+    set_retire_batch_size(16);
+
+    std::thread t([] {
+        for (int i = 0; i < 40; ++i) {
+            retire(new Node(i));
+        }
+        // the last 8 stay private until the thread exits
+    });
+    t.join();
+
+    for (int i = 0; i < 10; ++i) {
+        retire(new Node(i));
+    }
+    reclaim();
+    ASSERT_EQ(c_.ctors(), 50);
+    ASSERT_EQ(c_.dtors(), 50);
+
+    set_retire_batch_size(1);
+}
+
+TEST(HazptrTest, domainIsolation) {
+    struct tag {
+    };
+    c_.clear();
+    auto &domain0 = domain<tag>();
+    ASSERT_EQ(&domain0, &domain<tag>());
+    ASSERT_NE(&domain0, &reclaimer::instance());
+
+    std::atomic<Node *> cell{new Node};
+    auto h = domain0.make_hazard_ptr();
+    h.protect(cell);
+    domain0.retire(cell.load());
+    retire(new Node);
+
+    // the default domain neither sees the retiree nor the hazard pointer of domain0
+    reclaim();
+    ASSERT_EQ(c_.dtors(), 1);
+    domain0.reclaim();
+    ASSERT_EQ(c_.dtors(), 1);
+
+    h.reset();
+    domain0.reclaim();
+    ASSERT_EQ(c_.dtors(), 2);
+}
+
+TEST(HazptrTest, cohort) {
+    c_.clear();
+    std::atomic<Node *> cell{new Node};
+    std::atomic<bool> protecting{false};
+    std::atomic<bool> release{false};
+    std::thread reader;
+    {
+        alp_utils::hazp::cohort cohort0;
+        for (int i = 0; i < 2500; ++i) {
+            cohort0.retire(new Node(i));
+        }
+        // unrelated reclaims never touch the cohort's objects
+        auto cohort_dtors = c_.dtors();
+        ASSERT_GT(cohort_dtors, 0);
+        reclaim();
+        ASSERT_EQ(c_.dtors(), cohort_dtors);
+
+        reader = std::thread([&] {
+            auto h = make_hazard_ptr();
+            h.protect(cell);
+            protecting.store(true);
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        while (!protecting.load()) {
+            std::this_thread::yield();
+        }
+        cohort0.retire(cell.load());
+        cohort0.reclaim();
+        ASSERT_EQ(c_.dtors(), 2500);
+        release.store(true);
+    }
+    // the cohort waited for the reader before it was destroyed
+    ASSERT_EQ(c_.dtors(), 2501);
+    reader.join();
+}
+
+TEST(HazptrTest, backgroundReclaimer) {
+    std::atomic<int> off_thread{0};
+    auto main_id = std::this_thread::get_id();
+    auto deleter = [&](int *p) {
+        if (std::this_thread::get_id() != main_id) {
+            off_thread.fetch_add(1);
+        }
+        delete p;
+    };
+
+    reclaimer domain0;
+    {
+        background_reclaimer worker(domain0);
+        for (int i = 0; i < 3000; ++i) {
+            domain0.retire(new int(i), deleter);
+        }
+        while (domain0.retired_bytes() != 0) {
+            std::this_thread::yield();
+        }
+    }
+    ASSERT_EQ(off_thread.load(), 3000);
+}
+
+TEST(HazptrTest, retiredByteLimit) {
+    c_.clear();
+    reclaimer domain0;
+    std::vector<std::function<void()>> parked;
+    domain0.set_executor([&](std::function<void()> task) { parked.push_back(std::move(task)); });
+
+    for (int i = 0; i < 1500; ++i) {
+        domain0.retire(new Node(i));
+    }
+    ASSERT_FALSE(parked.empty());
+    ASSERT_EQ(c_.dtors(), 0);
+    ASSERT_EQ(domain0.retired_bytes(), 1500 * sizeof(Node));
+
+    // over the limit the retiring thread reclaims inline
+    domain0.set_retired_byte_limit(100 * sizeof(Node));
+    domain0.retire(new Node);
+    ASSERT_EQ(c_.dtors(), 1501);
+    ASSERT_EQ(domain0.retired_bytes(), 0);
+
+    for (auto &task: parked) {
+        task();
+    }
+    domain0.set_executor(nullptr);
+}
+
+TEST(HazptrTest, forcedReclaimIsRateLimited) {
+    struct Big {
+        char payload[4096];
+    };
+
+    reclaimer domain0;
+    domain0.set_sync_period(std::chrono::hours(1));
+    domain0.set_retired_byte_limit(2 * sizeof(Big));
+    auto h = domain0.make_hazard_ptr<4>();
+    for (size_t i = 0; i < 4; ++i) {
+        auto big = new Big;
+        h[i].reset_protection(big);
+        domain0.retire(big);
+    }
+    // the protected objects keep the domain over the limit
+    ASSERT_EQ(domain0.retired_bytes(), 4 * sizeof(Big));
+
+    auto bulk_reclaims = domain0.stats().bulk_reclaims;
+    for (int i = 0; i < 100; ++i) {
+        domain0.retire(new int(i));
+    }
+    // 400 bytes are less than a quarter of the limit, at most one more forced reclaim ran
+    ASSERT_LE(domain0.stats().bulk_reclaims, bulk_reclaims + 1);
+
+    for (size_t i = 0; i < 4; ++i) {
+        h[i].reset();
+    }
+    domain0.reclaim();
+    ASSERT_EQ(domain0.retired_bytes(), 0);
+}
+
+TEST(HazptrTest, intrusiveObject) {
+    struct Obj : hazptr_obj_base<Obj> {
+        int val;
+
+        explicit Obj(int v) : val(v) { c_.inc_ctors(); }
+
+        ~Obj() { c_.inc_dtors(); }
+    };
+    c_.clear();
+
+    auto obj = new Obj(1);
+    std::atomic<Obj *> cell{obj};
+    auto h = make_hazard_ptr();
+    ASSERT_EQ(h.protect(cell)->val, 1);
+    obj->retire();
+    reclaim();
+    ASSERT_EQ(c_.dtors(), 0);
+    h.reset();
+    reclaim();
+    ASSERT_EQ(c_.dtors(), 1);
+
+    int deleted = 0;
+    struct Obj2 : hazptr_obj_base<Obj2, std::function<void(Obj2 *)>> {
+    };
+    {
+        alp_utils::hazp::cohort cohort0;
+        (new Obj(2))->retire(cohort0);
+        (new Obj2)->retire(cohort0, [&deleted](Obj2 *p) {
+            ++deleted;
+            delete p;
+        });
+        (new Obj(3))->retire();
+    }
+    reclaim();
+    ASSERT_EQ(c_.dtors(), 3);
+    ASSERT_EQ(deleted, 1);
+}
+
+TEST(HazptrTest, adaptiveThreshold) {
+    c_.clear();
+    reclaimer domain0;
+    ASSERT_EQ(domain0.reclaim_threshold(), reclaimer::kMinReclaimThreshold);
+    {
+        std::vector<hazard_ptr> hptrs;
+        for (int i = 0; i < 100; ++i) {
+            hptrs.emplace_back(domain0.make_hazard_ptr());
+        }
+        // slots are registered a whole block at a time
+        ASSERT_EQ(domain0.reclaim_threshold(), 104 * reclaimer::kReclaimMultiplier);
+    }
+
+    domain0.set_sync_period(std::chrono::hours(1));
+    domain0.set_reclaim_threshold(10, 0);
+    ASSERT_EQ(domain0.reclaim_threshold(), 10);
+
+    std::atomic<Node *> cell{new Node};
+    auto h = domain0.make_hazard_ptr();
+    h.protect(cell);
+    domain0.retire(cell.load());
+    for (int i = 0; i < 8; ++i) {
+        domain0.retire(new Node(i));
+    }
+    ASSERT_EQ(c_.dtors(), 0);
+    auto scans = domain0.counters().scans;
+    domain0.retire(new Node);
+    auto counters = domain0.counters();
+    ASSERT_EQ(counters.scans, scans + 1);
+    ASSERT_EQ(counters.last_kept, 1);
+    ASSERT_EQ(c_.dtors(), 9);
+    ASSERT_EQ(counters.reclaimed, 9);
+    h.reset();
+}
+
+static std::atomic<int> trace_calls{0};
+
+TEST(HazptrTest, reclaimStats) {
+    reclaimer domain0;
+    domain0.set_sync_period(std::chrono::hours(1));
+    domain0.set_trace_hook([](const reclaimer &, reclaimer::trace_point, uint64_t) { trace_calls.fetch_add(1); });
+
+    std::atomic<Node *> cell{new Node};
+    auto h = domain0.make_hazard_ptr();
+    h.protect(cell);
+    { auto idle = domain0.make_hazard_ptr(); }
+
+    std::thread t([&] {
+        for (int i = 0; i < 10; ++i) {
+            domain0.retire(new Node(i));
+        }
+    });
+    t.join();
+    domain0.retire(cell.load());
+
+    auto stats = domain0.stats();
+    ASSERT_EQ(stats.retired, 11);
+    ASSERT_EQ(stats.unreclaimed, 11);
+    ASSERT_EQ(stats.unreclaimed_bytes, 11 * sizeof(Node));
+    // one block, the idle slot and the rest of the block are free
+    ASSERT_EQ(stats.holders_allocated, 8);
+    ASSERT_EQ(stats.holders_free, 7);
+    ASSERT_EQ(stats.holders_protecting, 1);
+
+    auto bulk_reclaims = stats.bulk_reclaims;
+    trace_calls.store(0);
+    domain0.reclaim();
+    stats = domain0.stats();
+    ASSERT_EQ(stats.unreclaimed, 1);
+    ASSERT_EQ(stats.unreclaimed_bytes, sizeof(Node));
+    ASSERT_EQ(stats.bulk_reclaims, bulk_reclaims + 1);
+    uint64_t scans = 0;
+    for (auto count: stats.scan_duration) {
+        scans += count;
+    }
+    ASSERT_EQ(scans, stats.bulk_reclaims);
+    ASSERT_EQ(trace_calls.load(), 2);
+
+    h.reset();
+    domain0.reclaim();
+    ASSERT_EQ(domain0.stats().unreclaimed, 0);
+    domain0.set_trace_hook(nullptr);
+}
+
+TEST(HazptrTest, holderReuse) {
+    reclaimer domain0;
+    domain0.set_sync_period(std::chrono::hours(1));
+    { auto h = domain0.make_hazard_ptr<4>(); }
+    ASSERT_EQ(domain0.stats().holders_allocated, 8);
+
+    // holders are taken and given back while another thread scans the list
+    std::atomic<bool> done{false};
+    std::thread scanner([&] {
+        while (!done.load()) {
+            domain0.retire(new Node);
+            domain0.reclaim();
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            std::atomic<Node *> cell{new Node};
+            for (int i = 0; i < 1000; ++i) {
+                auto h = domain0.make_hazard_ptr();
+                ASSERT_EQ(h.protect(cell)->value(), 0);
+            }
+            delete cell.load();
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    done.store(true);
+    scanner.join();
+
+    auto stats = domain0.stats();
+    ASSERT_LE(stats.holders_allocated, 16);
+    ASSERT_EQ(stats.holders_free, stats.holders_allocated);
+}
+
+TEST(HazptrTest, deleteHazardPtrReleasesThreadCache) {
+    std::thread t([] {
+        { auto h = make_hazard_ptr<3>(); }
+        // the three holders sit in this thread's cache, not in the domain
+        auto cached = reclaimer::instance().stats().holders_free;
+        delete_hazard_ptr();
+        ASSERT_GE(reclaimer::instance().stats().holders_free, cached + 3);
+    });
+    t.join();
+}
+
 // Benchmark drivers
 
 struct Barrier {
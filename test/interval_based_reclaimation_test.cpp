@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/concurrency/interval_based_reclaimation.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace alp_utils::ibr;
+
+static std::atomic<int> dtors{0};
+
+struct Node : ibr_obj_base<Node> {
+    explicit Node(int v = 0) : val(v) {}
+
+    ~Node() { dtors.fetch_add(1); }
+
+    int val;
+};
+
+struct Plain {
+    ~Plain() { dtors.fetch_add(1); }
+};
+
+class IbrTest : public testing::Test {
+protected:
+    void SetUp() override {
+        reclaim();
+        dtors.store(0);
+    }
+};
+
+TEST_F(IbrTest, retireAndReclaim) {
+    for (int i = 0; i < 10; ++i) {
+        (new Node(i))->retire();
+        retire(new Plain);
+    }
+    reclaim();
+    ASSERT_EQ(dtors.load(), 20);
+    ASSERT_EQ(reclaimer::instance().pending(), 0);
+}
+
+TEST_F(IbrTest, readerKeepsRetiredObject) {
+    std::atomic<Node *> cell{new Node(42)};
+    std::atomic<bool> entered{false};
+    std::atomic<bool> retired{false};
+
+    std::thread reader([&] {
+        guard g;
+        auto node = g.protect(cell);
+        entered.store(true);
+        while (!retired.load()) {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(node->val, 42);
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    cell.exchange(new Node(43))->retire();
+    reclaim();
+    ASSERT_EQ(dtors.load(), 0);
+    retired.store(true);
+    reader.join();
+
+    reclaim();
+    ASSERT_EQ(dtors.load(), 1);
+    cell.load()->retire();
+    reclaim();
+}
+
+TEST_F(IbrTest, stalledReaderOnlyPinsOverlappingObjects) {
+    auto old_node = new Node;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> done{false};
+
+    std::thread reader([&] {
+        guard g;
+        entered.store(true);
+        while (!done.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    // born before the reader entered, its lifetime overlaps the reservation
+    old_node->retire();
+    // treated as born at era 0
+    retire(new Plain);
+    reclaim();
+    ASSERT_EQ(dtors.load(), 0);
+
+    // born after the reader stopped observing new eras
+    for (int i = 0; i < 100; ++i) {
+        (new Node(i))->retire();
+    }
+    reclaim();
+    ASSERT_EQ(dtors.load(), 100);
+    ASSERT_EQ(reclaimer::instance().pending(), 2);
+
+    done.store(true);
+    reader.join();
+    reclaim();
+    ASSERT_EQ(dtors.load(), 102);
+}
+
+TEST_F(IbrTest, nestedCriticalSection) {
+    auto &domain = reclaimer::instance();
+    enter();
+    enter();
+    exit();
+    ASSERT_TRUE(domain.in_critical_section());
+    exit();
+    ASSERT_FALSE(domain.in_critical_section());
+}
+
+TEST_F(IbrTest, exitedThreadHandsOff) {
+    std::thread t([] {
+        for (int i = 0; i < 10; ++i) {
+            (new Node(i))->retire();
+        }
+    });
+    t.join();
+    reclaim();
+    ASSERT_EQ(dtors.load(), 10);
+}
+
+TEST_F(IbrTest, concurrentReadRetire) {
+    constexpr int kReaders = 4;
+    constexpr int kUpdates = 10000;
+    std::atomic<Node *> cell{new Node(0)};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                guard g;
+                for (int j = 0; j < 8; ++j) {
+                    auto node = g.protect(cell);
+                    ASSERT_GE(node->val, last);
+                    last = node->val;
+                }
+            }
+        });
+    }
+
+    for (int i = 1; i <= kUpdates; ++i) {
+        cell.exchange(new Node(i))->retire();
+    }
+    done.store(true);
+    for (auto &t: readers) {
+        t.join();
+    }
+    reclaim();
+    ASSERT_EQ(dtors.load(), kUpdates);
+    cell.load()->retire();
+    reclaim();
+}
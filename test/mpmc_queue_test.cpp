@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/container/mpmc_queue.h>
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using alp_utils::bounded_queue;
+using alp_utils::unbounded_queue;
+
+TEST(MpmcQueueTest, boundedFifo) {
+    bounded_queue<int> queue(3);
+    ASSERT_EQ(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_push(i));
+    }
+    ASSERT_FALSE(queue.try_push(4));
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_pop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.try_pop(value));
+}
+
+TEST(MpmcQueueTest, boundedBulk) {
+    bounded_queue<int> queue(8);
+    std::vector<int> in(10);
+    std::iota(in.begin(), in.end(), 0);
+    ASSERT_EQ(queue.try_push_bulk(in.begin(), in.size()), 8);
+    ASSERT_EQ(queue.size(), 8);
+
+    std::vector<int> out;
+    ASSERT_EQ(queue.try_pop_bulk(std::back_inserter(out), 5), 5);
+    ASSERT_EQ(queue.try_push_bulk(in.begin() + 8, 2), 2);
+    ASSERT_EQ(queue.try_pop_bulk(std::back_inserter(out), 100), 5);
+    ASSERT_EQ(out, in);
+}
+
+TEST(MpmcQueueTest, boundedCopies) {
+    bounded_queue<std::string> queue(4);
+    const std::string first(100, 'a');
+    ASSERT_TRUE(queue.try_push(first));
+    ASSERT_TRUE(queue.try_emplace(3, 'b'));
+
+    const std::vector<std::string> in{"c", "d", "e"};
+    ASSERT_EQ(queue.try_push_bulk(in.begin(), in.size()), 2);
+    ASSERT_EQ(in[0], "c");
+
+    std::vector<std::string> out;
+    ASSERT_EQ(queue.try_pop_bulk(std::back_inserter(out), 10), 4);
+    ASSERT_EQ(out, (std::vector<std::string>{first, "bbb", "c", "d"}));
+}
+
+TEST(MpmcQueueTest, unboundedAcrossSegments) {
+    unbounded_queue<std::unique_ptr<int>, 4> queue;
+    ASSERT_TRUE(queue.empty());
+    for (int i = 0; i < 10; ++i) {
+        queue.push(std::make_unique<int>(i));
+    }
+    std::unique_ptr<int> value;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue.try_pop(value));
+        ASSERT_EQ(*value, i);
+    }
+    ASSERT_FALSE(queue.try_pop(value));
+    ASSERT_TRUE(queue.empty());
+
+    // left over values are destroyed with the queue
+    queue.push(std::make_unique<int>(10));
+}
+
+struct checked {
+    explicit checked(int value) : value_(value) {
+        if (value < 0) {
+            throw std::invalid_argument("negative");
+        }
+    }
+
+    int value_;
+};
+
+TEST(MpmcQueueTest, unboundedThrowingConstructor) {
+    unbounded_queue<checked, 4> queue;
+    queue.emplace(1);
+    ASSERT_THROW(queue.emplace(-1), std::invalid_argument);
+    queue.emplace(2);
+
+    // the cell of the failed push is skipped, it may cost a pop that returns false
+    std::vector<int> out;
+    while (!queue.empty()) {
+        checked value(0);
+        if (queue.try_pop(value)) {
+            out.push_back(value.value_);
+        }
+    }
+    ASSERT_EQ(out, (std::vector<int>{1, 2}));
+}
+
+TEST(MpmcQueueTest, boundedThrowingConstructor) {
+    bounded_queue<checked> queue(2);
+    ASSERT_THROW(queue.try_emplace(-1), std::invalid_argument);
+    // the value is built before a cell is claimed, so no cell was lost
+    ASSERT_TRUE(queue.try_emplace(1));
+    ASSERT_TRUE(queue.try_emplace(2));
+    ASSERT_FALSE(queue.try_emplace(3));
+
+    checked value(0);
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value.value_, 1);
+    ASSERT_TRUE(queue.try_pop(value));
+    ASSERT_EQ(value.value_, 2);
+    ASSERT_FALSE(queue.try_pop(value));
+}
+
+// takes two values, then throws
+struct throwing_sink {
+    std::vector<int> *out;
+
+    throwing_sink &operator*() { return *this; }
+
+    throwing_sink operator++(int) { return *this; }
+
+    throwing_sink &operator=(int value) {
+        if (out->size() == 2) {
+            throw std::length_error("full");
+        }
+        out->push_back(value);
+        return *this;
+    }
+};
+
+TEST(MpmcQueueTest, boundedPopBulkThrowingOutput) {
+    bounded_queue<int> queue(8);
+    std::vector<int> in(8);
+    std::iota(in.begin(), in.end(), 0);
+    ASSERT_EQ(queue.try_push_bulk(in.begin(), 6), 6);
+
+    std::vector<int> out;
+    ASSERT_THROW(queue.try_pop_bulk(throwing_sink{&out}, 6), std::length_error);
+    ASSERT_EQ(out, (std::vector<int>{0, 1}));
+
+    // every claimed cell was released, the whole ring is usable again
+    int value = -1;
+    ASSERT_FALSE(queue.try_pop(value));
+    ASSERT_EQ(queue.try_push_bulk(in.begin(), in.size()), 8);
+    out.clear();
+    ASSERT_EQ(queue.try_pop_bulk(std::back_inserter(out), 8), 8);
+    ASSERT_EQ(out, in);
+}
+
+TEST(MpmcQueueTest, unboundedBulk) {
+    unbounded_queue<int, 8> queue;
+    std::vector<int> in(20);
+    std::iota(in.begin(), in.end(), 0);
+    queue.push_bulk(in.begin(), in.end());
+
+    std::vector<int> out;
+    while (queue.try_pop_bulk(std::back_inserter(out), 7) != 0) {
+    }
+    ASSERT_EQ(out, in);
+}
+
+template<typename Push, typename Pop>
+static void producers_consumers(Push &&push, Pop &&pop) {
+    constexpr int kThreads = 4;
+    constexpr int kPerProducer = 20000;
+    std::atomic<int64_t> sum{0};
+    std::atomic<int> consumed{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                push(t * kPerProducer + i + 1);
+            }
+        });
+        threads.emplace_back([&] {
+            int value = 0;
+            while (consumed.load() < kThreads * kPerProducer) {
+                if (pop(value)) {
+                    sum.fetch_add(value);
+                    consumed.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    int64_t n = kThreads * kPerProducer;
+    ASSERT_EQ(consumed.load(), n);
+    ASSERT_EQ(sum.load(), n * (n + 1) / 2);
+}
+
+TEST(MpmcQueueTest, boundedConcurrent) {
+    bounded_queue<int> queue(64);
+    producers_consumers([&](int v) {
+        while (!queue.try_push(v)) {
+            std::this_thread::yield();
+        }
+    }, [&](int &v) { return queue.try_pop(v); });
+}
+
+TEST(MpmcQueueTest, unboundedConcurrent) {
+    unbounded_queue<int, 32> queue;
+    producers_consumers([&](int v) { queue.push(v); }, [&](int &v) { return queue.try_pop(v); });
+}
+
+TEST(MpmcQueueTest, unboundedConcurrentEbr) {
+    unbounded_queue<int, 32, alp_utils::ebr_reclamation> queue;
+    producers_consumers([&](int v) { queue.push(v); }, [&](int &v) { return queue.try_pop(v); });
+}
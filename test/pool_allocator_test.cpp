@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/allocator/allocator_concepts.h>
+#include <cpp_utils/allocator/pool_allocator.h>
+#include <cpp_utils/container/avl_map.h>
+#include <cpp_utils/container/nd_heap.h>
+
+#include <algorithm>
+#include <list>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+using alp_utils::pool_allocator;
+
+static_assert(alp_utils::is_std_alloc_v<std::allocator<int>, int>);
+static_assert(alp_utils::is_std_alloc_v<pool_allocator<int>, int>);
+
+TEST(PoolAllocatorTest, reusesFreedObjects) {
+    pool_allocator<uint64_t> alloc;
+    auto a = alloc.allocate(1);
+    auto b = alloc.allocate(1);
+    ASSERT_NE(a, b);
+    alloc.deallocate(a, 1);
+    // the thread cache hands out the last freed object first
+    ASSERT_EQ(alloc.allocate(1), a);
+    alloc.deallocate(a, 1);
+    alloc.deallocate(b, 1);
+
+    // larger than any size class
+    auto big = alloc.allocate(1024);
+    big[1023] = 1;
+    alloc.deallocate(big, 1024);
+}
+
+TEST(PoolAllocatorTest, alignment) {
+    struct alignas(64) wide {
+        char data[64];
+    };
+    pool_allocator<wide> wide_alloc;
+    auto w = wide_alloc.allocate(3);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(w) % 64, 0);
+    wide_alloc.deallocate(w, 3);
+
+    pool_allocator<long double> alloc;
+    for (size_t n = 1; n < 40; ++n) {
+        auto p = alloc.allocate(n);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(long double), 0);
+        alloc.deallocate(p, n);
+    }
+}
+
+TEST(PoolAllocatorTest, containers) {
+    alp_utils::avl_map<int, int, std::less<int>, pool_allocator<std::pair<const int, int>>> map;
+    std::vector<int> keys(10000);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    for (auto key: keys) {
+        map.emplace(key, key * 2);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    for (size_t i = 0; i < keys.size() / 2; ++i) {
+        map.erase(keys[i]);
+    }
+    ASSERT_EQ(map.size(), keys.size() / 2);
+    for (size_t i = keys.size() / 2; i < keys.size(); ++i) {
+        ASSERT_EQ(map.find(keys[i])->second, keys[i] * 2);
+    }
+
+    alp_utils::nd_heap<int, 4, std::less<int>, pool_allocator<int>> heap;
+    for (auto key: keys) {
+        heap.push(key);
+    }
+    ASSERT_EQ(heap.top(), static_cast<int>(keys.size()) - 1);
+}
+
+// objects are freed by another thread than the one that allocated them
+TEST(PoolAllocatorTest, crossThreadFree) {
+    constexpr int kRounds = 50;
+    constexpr size_t kObjects = 5000;
+    for (int round = 0; round < kRounds; ++round) {
+        std::vector<std::list<int, pool_allocator<int>>> lists(2);
+        std::thread producer([&] {
+            for (size_t i = 0; i < kObjects; ++i) {
+                lists[0].push_back(static_cast<int>(i));
+                lists[1].push_front(static_cast<int>(i));
+            }
+        });
+        producer.join();
+        std::thread consumer([&] {
+            ASSERT_EQ(lists[0].size(), kObjects);
+            lists[0].clear();
+        });
+        lists[1].clear();
+        consumer.join();
+    }
+}
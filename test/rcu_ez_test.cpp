@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/concurrency/rcu_ez.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using alp_utils::rcu_ez;
+
+static std::atomic<int> dtors{0};
+
+struct Version {
+    explicit Version(int v) : val(v) {}
+
+    ~Version() { dtors.fetch_add(1); }
+
+    int val;
+};
+
+TEST(RcuEzTest, loadStore) {
+    rcu_ez<std::string> rcu;
+    ASSERT_FALSE(rcu.load());
+
+    rcu.store("hello");
+    {
+        auto ptr = rcu.load();
+        ASSERT_TRUE(ptr);
+        ASSERT_EQ(*ptr, "hello");
+    }
+
+    rcu.store(3, 'x');
+    ASSERT_EQ(*rcu.load(), "xxx");
+}
+
+TEST(RcuEzTest, readerKeepsOldVersion) {
+    dtors.store(0);
+    {
+        rcu_ez<Version> rcu;
+        rcu.store(1);
+        {
+            auto ptr = rcu.load();
+            rcu.store(2);
+            alp_utils::ebr::reclaim();
+            ASSERT_EQ(dtors.load(), 0);
+            ASSERT_EQ(ptr->val, 1);
+            ASSERT_EQ(rcu.load()->val, 2);
+        }
+        alp_utils::ebr::reclaim();
+        ASSERT_EQ(dtors.load(), 1);
+    }
+    ASSERT_EQ(dtors.load(), 2);
+}
+
+TEST(RcuEzTest, readPtrMoves) {
+    dtors.store(0);
+    {
+        rcu_ez<Version> rcu;
+        rcu.store(1);
+        auto ptr = rcu.load();
+        auto moved = std::move(ptr);
+        ASSERT_FALSE(ptr);
+        ASSERT_EQ(moved->val, 1);
+
+        std::vector<rcu_ez<Version>::read_ptr> held;
+        held.push_back(std::move(moved));
+        rcu.store(2);
+        held.push_back(rcu.load());
+        rcu.store(3);
+        alp_utils::ebr::reclaim();
+        ASSERT_EQ(dtors.load(), 0);
+        ASSERT_EQ(held[0]->val, 1);
+        ASSERT_EQ(held[1]->val, 2);
+
+        // the moved from pointers left no critical section behind
+        held.clear();
+        alp_utils::ebr::reclaim();
+        ASSERT_EQ(dtors.load(), 2);
+    }
+    ASSERT_EQ(dtors.load(), 3);
+}
+
+TEST(RcuEzTest, concurrentReadStore) {
+    constexpr int kReaders = 4;
+    constexpr int kUpdates = 10000;
+    rcu_ez<Version> rcu;
+    rcu.store(0);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                auto ptr = rcu.load();
+                ASSERT_GE(ptr->val, last);
+                last = ptr->val;
+            }
+        });
+    }
+
+    for (int i = 1; i <= kUpdates; ++i) {
+        rcu.store(i);
+    }
+    done.store(true);
+    for (auto &t: readers) {
+        t.join();
+    }
+    ASSERT_EQ(rcu.load()->val, kUpdates);
+}
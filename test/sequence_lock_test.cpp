@@ -125,4 +125,100 @@ TEST_F(SeqLockTest, RetryLoad) {
     ptr = sl.load_shared(1);
     ASSERT_TRUE(ptr);
     EXPECT_EQ(*ptr, 42);
-}
\ No newline at end of file
+}
+
+struct Quote {
+    int64_t bid;
+    int64_t ask;
+    int64_t volume;
+};
+
+TEST_F(SeqLockTest, InlineValue) {
+    alp_utils::inline_seq_lock<Quote> sl(Quote{1, 2, 3});
+    auto quote = sl.load();
+    EXPECT_EQ(quote.bid, 1);
+    EXPECT_EQ(quote.volume, 3);
+
+    sl.update([](Quote &q) { q.ask = 5; });
+    auto retried = sl.load(1);
+    ASSERT_TRUE(retried);
+    EXPECT_EQ(retried->bid, 1);
+    EXPECT_EQ(retried->ask, 5);
+
+    sl.store(Quote{7, 8, 9});
+    EXPECT_EQ(sl.load().volume, 9);
+}
+
+TEST_F(SeqLockTest, InlineValueNotTorn) {
+    alp_utils::inline_seq_lock<Quote> sl(Quote{0, 0, 0});
+    std::atomic<bool> running{true};
+
+    std::thread writer([&] {
+        for (int64_t i = 1; running; ++i) {
+            sl.store(Quote{i, i, i});
+        }
+    });
+
+    for (int i = 0; i < 100000; ++i) {
+        auto quote = sl.load();
+        ASSERT_EQ(quote.bid, quote.ask);
+        ASSERT_EQ(quote.ask, quote.volume);
+    }
+    running = false;
+    writer.join();
+}
+
+TEST_F(SeqLockTest, InlineConcurrentUpdates) {
+    alp_utils::inline_seq_lock<Quote> sl;
+    constexpr int kUpdates = 10000;
+
+    auto add = [&] {
+        for (int i = 0; i < kUpdates; ++i) {
+            sl.update([](Quote &q) { ++q.volume; });
+        }
+    };
+    std::thread first(add);
+    std::thread second(add);
+    first.join();
+    second.join();
+
+    EXPECT_EQ(sl.load().volume, 2 * kUpdates);
+}
+
+TEST_F(SeqLockTest, RingLoadsNewest) {
+    alp_utils::seq_ring<Quote, 4> ring(Quote{0, 0, 0});
+    EXPECT_EQ(ring.load().bid, 0);
+
+    for (int64_t i = 1; i <= 10; ++i) {
+        ring.store(Quote{i, i, i});
+        EXPECT_EQ(ring.load().bid, i);
+    }
+    ring.update([](Quote &q) { q.volume = 42; });
+    auto quote = ring.load(1);
+    ASSERT_TRUE(quote);
+    EXPECT_EQ(quote->bid, 10);
+    EXPECT_EQ(quote->volume, 42);
+    EXPECT_EQ(ring.version(), 11);
+}
+
+TEST_F(SeqLockTest, RingNotTorn) {
+    alp_utils::seq_ring<Quote, 4> ring;
+    std::atomic<bool> running{true};
+
+    std::thread writer([&] {
+        for (int64_t i = 1; running; ++i) {
+            ring.store(Quote{i, i, i});
+        }
+    });
+
+    int64_t last = 0;
+    for (int i = 0; i < 100000; ++i) {
+        auto quote = ring.load();
+        ASSERT_EQ(quote.bid, quote.ask);
+        ASSERT_EQ(quote.ask, quote.volume);
+        ASSERT_GE(quote.bid, last);
+        last = quote.bid;
+    }
+    running = false;
+    writer.join();
+}
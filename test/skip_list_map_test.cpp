@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/container/skip_list_map.h>
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+using alp_utils::skip_list_map;
+
+TEST(SkipListMapTest, insertFindErase) {
+    skip_list_map<int, int> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.insert({2, 20}));
+    ASSERT_TRUE(map.emplace(1, 10));
+    ASSERT_TRUE(map.emplace(3, 30));
+    ASSERT_FALSE(map.emplace(2, 21));
+    ASSERT_EQ(map.size(), 3);
+
+    auto it = map.find(2);
+    ASSERT_NE(it, map.end());
+    ASSERT_EQ(it->second, 20);
+    ASSERT_EQ(map.find(4), map.end());
+    ASSERT_TRUE(map.contains(3));
+
+    ASSERT_TRUE(map.erase(2));
+    ASSERT_FALSE(map.erase(2));
+    ASSERT_FALSE(map.contains(2));
+    // the iterator still holds the erased entry
+    ASSERT_EQ(it->second, 20);
+    ++it;
+    ASSERT_EQ(it->first, 3);
+    ASSERT_EQ(map.size(), 2);
+}
+
+TEST(SkipListMapTest, orderedIteration) {
+    skip_list_map<int, int> map;
+    std::map<int, int> expected;
+    std::mt19937 gen(42);
+    for (int i = 0; i < 1000; ++i) {
+        auto key = static_cast<int>(gen() % 2000);
+        ASSERT_EQ(map.emplace(key, i), expected.emplace(key, i).second);
+    }
+    for (int i = 0; i < 500; ++i) {
+        auto key = static_cast<int>(gen() % 2000);
+        ASSERT_EQ(map.erase(key), expected.erase(key) == 1);
+    }
+
+    auto it = expected.begin();
+    for (auto &[key, value]: map) {
+        ASSERT_EQ(key, it->first);
+        ASSERT_EQ(value, it->second);
+        ++it;
+    }
+    ASSERT_EQ(it, expected.end());
+
+    auto lower = map.lower_bound(1000);
+    auto expected_lower = expected.lower_bound(1000);
+    ASSERT_EQ(lower->first, expected_lower->first);
+    auto upper = map.upper_bound(expected_lower->first);
+    ASSERT_EQ(upper->first, std::next(expected_lower)->first);
+}
+
+TEST(SkipListMapTest, concurrentInsertErase) {
+    constexpr int kThreads = 8;
+    constexpr int kKeys = 512;
+    constexpr int kOps = 20000;
+    skip_list_map<int, int> map;
+    std::atomic<int> balance{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            int local = 0;
+            for (int i = 0; i < kOps; ++i) {
+                auto key = static_cast<int>(gen() % kKeys);
+                switch (gen() % 3) {
+                    case 0:
+                        local += map.emplace(key, key);
+                        break;
+                    case 1:
+                        local -= map.erase(key);
+                        break;
+                    default: {
+                        auto it = map.find(key);
+                        if (it != map.end()) {
+                            ASSERT_EQ(it->second, key);
+                        }
+                    }
+                }
+            }
+            balance.fetch_add(local);
+        });
+    }
+    // readers keep walking the map while it changes
+    std::thread reader([&] {
+        for (int i = 0; i < 200; ++i) {
+            int last = -1;
+            for (auto &[key, value]: map) {
+                ASSERT_GT(key, last);
+                last = key;
+            }
+        }
+    });
+    for (auto &t: threads) {
+        t.join();
+    }
+    reader.join();
+
+    int count = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ++count;
+    }
+    ASSERT_EQ(count, balance.load());
+    ASSERT_EQ(map.size(), balance.load());
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <cpp_utils/concurrency/spin_mutex.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using alp_utils::spin_mutex;
+
+TEST(SpinMutexTest, tryLock) {
+    spin_mutex mutex;
+    ASSERT_TRUE(mutex.try_lock());
+    ASSERT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(SpinMutexTest, parkedWaiterIsWoken) {
+    spin_mutex mutex;
+    std::atomic<bool> acquired{false};
+    mutex.lock();
+
+    std::thread waiter([&] {
+        std::lock_guard lock(mutex);
+        acquired.store(true);
+    });
+    // long enough for the waiter to give up spinning and park
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(acquired.load());
+
+    mutex.unlock();
+    waiter.join();
+    ASSERT_TRUE(acquired.load());
+}
+
+TEST(SpinMutexTest, mutualExclusion) {
+    constexpr int kThreads = 8;
+    constexpr int kIncrements = 100000;
+    spin_mutex mutex;
+    int64_t counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kIncrements; ++j) {
+                std::lock_guard lock(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    ASSERT_EQ(counter, kThreads * kIncrements);
+}